@@ -0,0 +1,122 @@
+#include "AutoTuner.h"
+
+#include <algorithm>
+#include <cmath>
+
+AutoTuner::AutoTuner(
+	const std::vector<Parameter>& parameters,
+	UINT framesPerMeasure,
+	float hysteresis)
+	: _parameters(parameters)
+	, _framesPerMeasure(std::max(framesPerMeasure, 1u))
+	, _hysteresis(hysteresis)
+{
+	for (UINT parameter = 0; parameter < _parameters.size(); parameter++)
+	{
+		assert(!_parameters[parameter].values.empty());
+		assert(_parameters[parameter].initialIndex
+			< _parameters[parameter].values.size());
+
+		_indices.push_back(_parameters[parameter].initialIndex);
+		_moves.push_back({ parameter, 1 });
+		_moves.push_back({ parameter, -1 });
+	}
+}
+
+bool AutoTuner::AddFrame(float cost)
+{
+	if (_warmupFrames > 0)
+	{
+		_warmupFrames--;
+		return false;
+	}
+
+	_frameCosts.push_back(cost);
+	if (_frameCosts.size() < _framesPerMeasure)
+	{
+		return false;
+	}
+	float measuredCost = _takeMedian();
+
+	switch (_state)
+	{
+	case State::Measure:
+		_cost = measuredCost;
+		_nextMove();
+		return false;
+	case State::Explore:
+		if (measuredCost < _cost * (1.0f - _hysteresis))
+		{
+			// the same move is tried again from the new configuration
+			const Move& move = _moves[_moveIndex];
+			_indices[move.parameter] += move.step;
+			_cost = measuredCost;
+			_movesTried = 0;
+			_nextMove();
+			return true;
+		}
+		_movesTried++;
+		_moveIndex = (_moveIndex + 1) % _moves.size();
+		_nextMove();
+		return false;
+	case State::Converged:
+		if (std::abs(measuredCost - _cost) > RetuneDrift * _cost)
+		{
+			Restart();
+		}
+		return false;
+	}
+
+	return false;
+}
+
+UINT AutoTuner::GetValue(UINT parameter) const
+{
+	UINT index = _indices[parameter];
+	if (_state == State::Explore && _moves[_moveIndex].parameter == parameter)
+	{
+		index += _moves[_moveIndex].step;
+	}
+
+	return _parameters[parameter].values[index];
+}
+
+void AutoTuner::Restart()
+{
+	_state = State::Measure;
+	_movesTried = 0;
+	_warmupFrames = 1;
+	_frameCosts.clear();
+}
+
+bool AutoTuner::_nextMove()
+{
+	// values change either way
+	_warmupFrames = 1;
+
+	for (; _movesTried < _moves.size(); _movesTried++)
+	{
+		const Move& move = _moves[_moveIndex];
+		INT index = static_cast<INT>(_indices[move.parameter]) + move.step;
+		if (index >= 0 && index
+			< static_cast<INT>(_parameters[move.parameter].values.size()))
+		{
+			_state = State::Explore;
+			return true;
+		}
+		_moveIndex = (_moveIndex + 1) % _moves.size();
+	}
+
+	_state = State::Converged;
+	return false;
+}
+
+float AutoTuner::_takeMedian()
+{
+	auto middle = _frameCosts.begin() + _frameCosts.size() / 2;
+	std::nth_element(_frameCosts.begin(), middle, _frameCosts.end());
+	float median = *middle;
+	_frameCosts.clear();
+
+	return median;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Common.h"
+
+#include <vector>
+
+// online hill climbing over parameters with discrete values,
+// one neighbour of the current configuration is measured at a time
+// and is kept only if it's faster by more than the hysteresis,
+// so frame to frame noise doesn't make it oscillate
+//
+// once no neighbour is better it stays, until the cost of the configuration
+// drifts away from the converged one, e.g. after a scene or camera change
+class AutoTuner
+{
+public:
+
+	struct Parameter
+	{
+		// in the order of the cost trend, neighbours are adjacent
+		std::vector<UINT> values;
+		UINT initialIndex;
+	};
+
+	// framesPerMeasure - median of that many frames is the cost of
+	// a configuration, the first frame after a change is skipped
+	// hysteresis - min relative gain of a neighbour to be accepted
+	AutoTuner(
+		const std::vector<Parameter>& parameters,
+		UINT framesPerMeasure = 8,
+		float hysteresis = 0.05f);
+
+	// cost of the frame rendered with the current values,
+	// true if a new configuration was accepted
+	bool AddFrame(float cost);
+	// to use for the next frame
+	UINT GetValue(UINT parameter) const;
+	// of the last accepted configuration
+	float GetCost() const { return _cost; }
+	bool IsConverged() const { return _state == State::Converged; }
+	// explores again from the current configuration
+	void Restart();
+
+private:
+
+	enum class State
+	{
+		// the current configuration
+		Measure,
+		// a neighbour of the current configuration
+		Explore,
+		// no neighbour is better
+		Converged
+	};
+
+	// a neighbour is the value next to the current one of a parameter
+	struct Move
+	{
+		UINT parameter;
+		INT step;
+	};
+
+	// false if no move is left to try
+	bool _nextMove();
+	float _takeMedian();
+
+	// relative change of the converged cost to explore again
+	static constexpr float RetuneDrift = 0.25f;
+
+	std::vector<Parameter> _parameters;
+	// of the accepted configuration
+	std::vector<UINT> _indices;
+	UINT _framesPerMeasure;
+	float _hysteresis;
+
+	State _state = State::Measure;
+	std::vector<Move> _moves;
+	UINT _moveIndex = 0;
+	// since the last accepted configuration
+	UINT _movesTried = 0;
+	// frames to skip before measuring
+	UINT _warmupFrames = 1;
+	std::vector<float> _frameCosts;
+	float _cost = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "TypesAndConstants.hlsli"
+
+// fills firstTile of the queued big triangles with the exclusive prefix sum
+// of their tilesCount, so a group of the big triangle passes can find
+// its triangle and tile with a binary search
+//
+// a single group walks the queue, which holds at most MaxBigTriangleTiles
+// triangles, so no partial sums have to be stitched across groups
+
+RWStructuredBuffer<BigTriangle> BigTriangles : register(u0);
+RWByteAddressBuffer BigTrianglesCounter : register(u1);
+
+groupshared uint Sums[SWRBigTriangleScanThreads];
+
+[numthreads(SWRBigTriangleScanThreads, 1, 1)]
+void main(
+	uint3 groupID : SV_GroupID,
+	uint3 dispatchThreadID : SV_DispatchThreadID,
+	uint3 groupThreadID : SV_GroupThreadID,
+	uint groupIndex : SV_GroupIndex)
+{
+	// runs past the capacity for the triangles that didn't fit
+	uint capacity, stride;
+	BigTriangles.GetDimensions(capacity, stride);
+	uint trianglesCount = min(
+		BigTrianglesCounter.Load(BigTrianglesCountOffset),
+		capacity);
+
+	uint firstTile = 0;
+	for (uint first = 0;
+		first < trianglesCount;
+		first += SWRBigTriangleScanThreads)
+	{
+		uint index = first + groupIndex;
+		uint tiles = 0;
+		[branch]
+		if (index < trianglesCount)
+		{
+			tiles = BigTriangles[index].tilesCount;
+		}
+		Sums[groupIndex] = tiles;
+
+		GroupMemoryBarrierWithGroupSync();
+
+		// inclusive, Hillis-Steele
+		[unroll]
+		for (uint offset = 1;
+			offset < SWRBigTriangleScanThreads;
+			offset *= 2)
+		{
+			uint sum = Sums[groupIndex];
+			if (groupIndex >= offset)
+			{
+				sum += Sums[groupIndex - offset];
+			}
+
+			GroupMemoryBarrierWithGroupSync();
+
+			Sums[groupIndex] = sum;
+
+			GroupMemoryBarrierWithGroupSync();
+		}
+
+		[branch]
+		if (index < trianglesCount)
+		{
+			BigTriangles[index].firstTile =
+				firstTile + Sums[groupIndex] - tiles;
+		}
+		firstTile += Sums[SWRBigTriangleScanThreads - 1];
+
+		// before the next chunk overwrites the sums
+		GroupMemoryBarrierWithGroupSync();
+	}
+}
\ No newline at end of file
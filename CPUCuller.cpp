@@ -0,0 +1,274 @@
+#include "CPUCuller.h"
+#include "Utils.h"
+#include "Scene.h"
+
+#include <chrono>
+
+using namespace DirectX;
+
+namespace
+{
+
+IndirectCommand MakeCommand(const MeshMeta& meshMeta, UINT instanceCount)
+{
+	IndirectCommand command = {};
+	command.startInstanceLocation = meshMeta.startInstanceLocation;
+	command.arguments.IndexCountPerInstance = meshMeta.indexCountPerInstance;
+	command.arguments.InstanceCount = instanceCount;
+	command.arguments.StartIndexLocation = meshMeta.startIndexLocation;
+	command.arguments.BaseVertexLocation = meshMeta.baseVertexLocation;
+	command.arguments.StartInstanceLocation = 0;
+
+	return command;
+}
+
+}
+
+void CPUCuller::Update(const CullingView* views, UINT viewsCount)
+{
+	assert(viewsCount <= Settings::MaxViewsCount);
+
+	_viewsCount = viewsCount;
+	memcpy(_views, views, sizeof(CullingView) * viewsCount);
+}
+
+void CPUCuller::SetHiZ(
+	UINT view,
+	const HiZPyramid* pyramid,
+	const XMFLOAT4X4& VP)
+{
+	assert(view < Settings::MaxViewsCount);
+
+	_HiZPyramids[view] = pyramid;
+	_HiZViewProjections[view] = VP;
+}
+
+void CPUCuller::Cull()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	_resize();
+
+	const auto& instances = Scene::CurrentScene->instancesCPU;
+	const auto& meshesMeta = Scene::CurrentScene->meshesMetaCPU;
+
+	for (UINT view = 0; view < _viewsCount; view++)
+	{
+		std::fill(
+			_instancesCounters[view].begin(),
+			_instancesCounters[view].end(),
+			0);
+		_culledCommands[view].clear();
+		_visibleInstancesCount[view] = 0;
+		_HiZOccludedCount[view] = 0;
+		_frustumCulledCount[view] = 0;
+	}
+	std::fill(
+		_cascadesInstancesCounters.begin(),
+		_cascadesInstancesCounters.end(),
+		0);
+	_cascadesCulledCommands.clear();
+	if (_hybridRoutingEnabled)
+	{
+		for (UINT view = 0; view < _viewsCount; view++)
+		{
+			for (UINT route = 0; route < HybridRouting::RoutesCount; route++)
+			{
+				std::fill(
+					_routedInstancesCounters[route][view].begin(),
+					_routedInstancesCounters[route][view].end(),
+					0);
+				_routedCommands[route][view].clear();
+			}
+			_meshletEstimates[view].clear();
+		}
+	}
+
+	// culling, memory is read once for all views
+	for (const Instance& instance : instances)
+	{
+		MeshMeta meshMeta = meshesMeta[instance.meshID];
+		if (_sphereCubeBounds)
+		{
+			const XMFLOAT4& sphere = meshMeta.boundingSphere;
+			meshMeta.AABB.center = { sphere.x, sphere.y, sphere.z };
+			meshMeta.AABB.extents = { sphere.w, sphere.w, sphere.w };
+		}
+		XMMATRIX worldTransform = XMLoadFloat4x4(&instance.worldTransform);
+		meshMeta.AABB = Utils::TransformAABB(meshMeta.AABB, worldTransform);
+		meshMeta.boundingSphere = Utils::TransformSphere(
+			meshMeta.boundingSphere,
+			worldTransform);
+		// TODO: cone axis should be rotated properly
+		XMVECTOR coneApex = XMVector3Transform(
+			XMLoadFloat3(&meshMeta.coneApex),
+			worldTransform);
+		XMVECTOR coneAxis = XMLoadFloat3(&meshMeta.coneAxis);
+
+		UINT cascadesMask = 0;
+		for (UINT view = 0; view < _viewsCount; view++)
+		{
+			const CullingView& cullingView = _views[view];
+
+			bool backface = XMVectorGetX(XMVector3Dot(
+				XMVector3Normalize(
+					coneApex - XMLoadFloat3(&cullingView.position)),
+				coneAxis)) >= meshMeta.coneCutoff;
+			bool FC =
+				Utils::AABBVsFrustum(meshMeta.AABB, cullingView.frustum) &&
+				Utils::SphereVsFrustum(
+					meshMeta.boundingSphere,
+					cullingView.frustum);
+			if (!FC && Settings::FrustumCullingEnabled)
+			{
+				_frustumCulledCount[view]++;
+			}
+
+			if ((!backface || !Settings::ClusterBackfaceCullingEnabled)
+				&& (FC || !Settings::FrustumCullingEnabled))
+			{
+				// the GPU Hi-Z is not read back, the pyramid is of depths
+				// drawn on CPU, if given
+				const HiZPyramid* pyramid = _HiZPyramids[view];
+				if (pyramid && cullingView.HiZCullingEnabled
+					&& pyramid->TestBox(
+						_HiZTest,
+						meshMeta.AABB,
+						_HiZViewProjections[view]) == HiZPyramid::Occluded)
+				{
+					_HiZOccludedCount[view]++;
+					continue;
+				}
+
+				UINT writeOffset =
+					_instancesCounters[view][instance.meshID]++;
+				_visibleInstances[view][
+					meshMeta.startInstanceLocation + writeOffset] = instance;
+				_visibleInstancesCount[view]++;
+
+				if (_hybridRoutingEnabled)
+				{
+					HybridRouting::MeshletEstimate estimate =
+						HybridRouting::Estimate(
+							meshMeta.AABB,
+							meshMeta.indexCountPerInstance / 3,
+							cullingView.VP,
+							cullingView.HiZResolution);
+					HybridRouting::Routes route = HybridRouting::Route(
+						estimate,
+						_hybridRoutingThreshold);
+					UINT routedOffset = _routedInstancesCounters[route][view][
+						instance.meshID]++;
+					_routedInstances[route][view][
+						meshMeta.startInstanceLocation + routedOffset] =
+						instance;
+					_meshletEstimates[view].push_back(estimate);
+				}
+
+				if (view > 0)
+				{
+					cascadesMask |= 1 << (view - 1);
+				}
+			}
+		}
+
+		if (cascadesMask != 0)
+		{
+			UINT writeOffset =
+				meshMeta.startInstanceLocation
+				+ _cascadesInstancesCounters[instance.meshID]++;
+			_cascadesVisibleInstances[writeOffset] = instance;
+			_cascadesMasks[writeOffset] = cascadesMask;
+		}
+	}
+
+	// commands generation
+	for (UINT view = 0; view < _viewsCount; view++)
+	{
+		for (UINT mesh = 0; mesh < meshesMeta.size(); mesh++)
+		{
+			UINT count = _instancesCounters[view][mesh];
+			if (count == 0)
+			{
+				continue;
+			}
+
+			_culledCommands[view].push_back(
+				MakeCommand(meshesMeta[mesh], count));
+		}
+	}
+	if (_hybridRoutingEnabled)
+	{
+		for (UINT view = 0; view < _viewsCount; view++)
+		{
+			for (UINT route = 0; route < HybridRouting::RoutesCount; route++)
+			{
+				for (UINT mesh = 0; mesh < meshesMeta.size(); mesh++)
+				{
+					UINT count = _routedInstancesCounters[route][view][mesh];
+					if (count != 0)
+					{
+						_routedCommands[route][view].push_back(
+							MakeCommand(meshesMeta[mesh], count));
+					}
+				}
+			}
+		}
+	}
+	for (UINT mesh = 0; mesh < meshesMeta.size(); mesh++)
+	{
+		UINT count = _cascadesInstancesCounters[mesh];
+		if (count == 0)
+		{
+			continue;
+		}
+
+		_cascadesCulledCommands.push_back(MakeCommand(meshesMeta[mesh], count));
+	}
+
+	auto finish = std::chrono::high_resolution_clock::now();
+	_cullingTimeMS =
+		std::chrono::duration<float, std::milli>(finish - start).count();
+}
+
+void CPUCuller::_resize()
+{
+	size_t instancesCount = Scene::CurrentScene->instancesCPU.size();
+	size_t meshesCount = Scene::CurrentScene->meshesMetaCPU.size();
+
+	for (UINT view = 0; view < _viewsCount; view++)
+	{
+		if (_visibleInstances[view].size() < instancesCount)
+		{
+			_visibleInstances[view].resize(instancesCount);
+		}
+		_instancesCounters[view].resize(meshesCount);
+		_culledCommands[view].reserve(meshesCount);
+	}
+
+	if (_cascadesVisibleInstances.size() < instancesCount)
+	{
+		_cascadesVisibleInstances.resize(instancesCount);
+		_cascadesMasks.resize(instancesCount);
+	}
+	_cascadesInstancesCounters.resize(meshesCount);
+	_cascadesCulledCommands.reserve(meshesCount);
+
+	if (!_hybridRoutingEnabled)
+	{
+		return;
+	}
+	for (UINT view = 0; view < _viewsCount; view++)
+	{
+		for (UINT route = 0; route < HybridRouting::RoutesCount; route++)
+		{
+			if (_routedInstances[route][view].size() < instancesCount)
+			{
+				_routedInstances[route][view].resize(instancesCount);
+			}
+			_routedInstancesCounters[route][view].resize(meshesCount);
+			_routedCommands[route][view].reserve(meshesCount);
+		}
+		_meshletEstimates[view].reserve(instancesCount);
+	}
+}
\ No newline at end of file
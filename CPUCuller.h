@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Types.h"
+#include "Settings.h"
+#include "HybridRouting.h"
+#include "HiZPyramid.h"
+
+#include <vector>
+
+// CPU reference of CullingCS + GenerateCommandsCS,
+// takes the same views and produces the same per view output
+class CPUCuller
+{
+public:
+
+	CPUCuller() = default;
+	CPUCuller(const CPUCuller&) = delete;
+	CPUCuller& operator=(const CPUCuller&) = delete;
+	~CPUCuller() = default;
+
+	void Update(const CullingView* views, UINT viewsCount);
+	void Cull();
+
+	// laid out as on GPU, instances of a mesh start at
+	// its startInstanceLocation
+	const std::vector<Instance>& GetVisibleInstances(UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _visibleInstances[view];
+	}
+	const std::vector<IndirectCommand>& GetCulledCommands(UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _culledCommands[view];
+	}
+	UINT GetVisibleInstancesCount(UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _visibleInstancesCount[view];
+	}
+	// the same for instances visible in any of the views after the first one,
+	// the cascades, with a bit per such view, so a multi-view pass
+	// can draw them in a single sweep
+	const std::vector<Instance>& GetCascadesVisibleInstances() const
+	{
+		return _cascadesVisibleInstances;
+	}
+	const std::vector<UINT>& GetCascadesMasks() const
+	{
+		return _cascadesMasks;
+	}
+	const std::vector<IndirectCommand>& GetCascadesCulledCommands() const
+	{
+		return _cascadesCulledCommands;
+	}
+	// when enabled, the visible instances of each view are also split
+	// between the software and hardware rasterizers by their estimated
+	// pixels per triangle, laid out the same way
+	void SetHybridRouting(bool enabled, float threshold)
+	{
+		_hybridRoutingEnabled = enabled;
+		_hybridRoutingThreshold = threshold;
+	}
+	bool IsHybridRouting() const { return _hybridRoutingEnabled; }
+	float GetHybridRoutingThreshold() const
+	{
+		return _hybridRoutingThreshold;
+	}
+	const std::vector<Instance>& GetRoutedInstances(
+		HybridRouting::Routes route,
+		UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _routedInstances[route][view];
+	}
+	const std::vector<IndirectCommand>& GetRoutedCommands(
+		HybridRouting::Routes route,
+		UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _routedCommands[route][view];
+	}
+	// one per visible instance, in culling order
+	const std::vector<HybridRouting::MeshletEstimate>& GetMeshletEstimates(
+		UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _meshletEstimates[view];
+	}
+	// the instances of a view with HiZCullingEnabled are tested against
+	// the pyramid of its depths drawn with VP, as CullingCS does against
+	// the previous frame's Hi-Z, nullptr disables it for the view
+	void SetHiZ(
+		UINT view,
+		const HiZPyramid* pyramid,
+		const DirectX::XMFLOAT4X4& VP);
+	void SetHiZTest(HiZPyramid::Tests test) { _HiZTest = test; }
+	HiZPyramid::Tests GetHiZTest() const { return _HiZTest; }
+	// of the last Cull(), past the frustum and backface tests
+	UINT GetHiZOccludedCount(UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _HiZOccludedCount[view];
+	}
+	// of the last Cull(), backfacing or not
+	UINT GetFrustumCulledCount(UINT view) const
+	{
+		assert(view < _viewsCount);
+		return _frustumCulledCount[view];
+	}
+	// tests the cubes of the meshlets' bounding spheres instead of
+	// their tight AABBs, as the meshlets were bounded before,
+	// for comparing the culling rates of the two
+	void SetSphereCubeBounds(bool enabled) { _sphereCubeBounds = enabled; }
+	UINT GetViewsCount() const { return _viewsCount; }
+	// of the last Cull()
+	float GetCullingTimeMS() const { return _cullingTimeMS; }
+
+private:
+
+	void _resize();
+
+	CullingView _views[Settings::MaxViewsCount];
+	UINT _viewsCount = 0;
+
+	std::vector<Instance> _visibleInstances[Settings::MaxViewsCount];
+	std::vector<UINT> _instancesCounters[Settings::MaxViewsCount];
+	std::vector<IndirectCommand> _culledCommands[Settings::MaxViewsCount];
+	UINT _visibleInstancesCount[Settings::MaxViewsCount] = {};
+
+	std::vector<Instance> _cascadesVisibleInstances;
+	std::vector<UINT> _cascadesMasks;
+	std::vector<UINT> _cascadesInstancesCounters;
+	std::vector<IndirectCommand> _cascadesCulledCommands;
+
+	bool _hybridRoutingEnabled = false;
+	float _hybridRoutingThreshold = 0.0f;
+	std::vector<Instance>
+		_routedInstances[HybridRouting::RoutesCount][Settings::MaxViewsCount];
+	std::vector<UINT> _routedInstancesCounters
+		[HybridRouting::RoutesCount][Settings::MaxViewsCount];
+	std::vector<IndirectCommand>
+		_routedCommands[HybridRouting::RoutesCount][Settings::MaxViewsCount];
+	std::vector<HybridRouting::MeshletEstimate>
+		_meshletEstimates[Settings::MaxViewsCount];
+
+	const HiZPyramid* _HiZPyramids[Settings::MaxViewsCount] = {};
+	DirectX::XMFLOAT4X4 _HiZViewProjections[Settings::MaxViewsCount];
+	HiZPyramid::Tests _HiZTest = HiZPyramid::FootprintTaps;
+	UINT _HiZOccludedCount[Settings::MaxViewsCount] = {};
+	UINT _frustumCulledCount[Settings::MaxViewsCount] = {};
+	bool _sphereCubeBounds = false;
+
+	float _cullingTimeMS = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,2298 @@
+#include "CPURasterizer.h"
+#include "RasterizerSetup.h"
+#include "Scene.h"
+#include "Shadows.h"
+#include "Utils.h"
+
+#include <DirectXPackedVector.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+using namespace DirectX;
+using namespace RasterizerSetup;
+
+namespace
+{
+
+XMVECTOR UnpackNormal(UINT packed)
+{
+	// 1 / (2 ^ N - 1), N = 10, see Scene.cpp normal packing
+	float denom = 1.0f / 1023.0f;
+
+	return XMVectorSet(
+		static_cast<float>((packed >> 20) & 0x3FF) * denom * 2.0f - 1.0f,
+		static_cast<float>((packed >> 10) & 0x3FF) * denom * 2.0f - 1.0f,
+		static_cast<float>(packed & 0x3FF) * denom * 2.0f - 1.0f,
+		0.0f);
+}
+
+XMVECTOR UnpackColor(const XMUINT2& packed)
+{
+	using PackedVector::HALF;
+	using PackedVector::XMConvertHalfToFloat;
+
+	return XMVectorSet(
+		XMConvertHalfToFloat(static_cast<HALF>(packed.x >> 16)),
+		XMConvertHalfToFloat(static_cast<HALF>(packed.x & 0xFFFF)),
+		XMConvertHalfToFloat(static_cast<HALF>(packed.y >> 16)),
+		XMConvertHalfToFloat(static_cast<HALF>(packed.y & 0xFFFF)));
+}
+
+UINT GetCascadeIndex(float viewDepth, const float* cascadeSplits)
+{
+	UINT cascadeIdx = Settings::CascadesCount - 1;
+	for (INT i = Settings::CascadesCount - 1; i >= 0; i--)
+	{
+		if (viewDepth <= cascadeSplits[i])
+		{
+			cascadeIdx = i;
+		}
+	}
+
+	return cascadeIdx;
+}
+
+// same as in GetCascadeColor
+const XMFLOAT3 CascadeColors[Settings::MaxCascadesCount] =
+{
+	{ 1.0f, 0.0f, 0.0f },
+	{ 0.0f, 1.0f, 0.0f },
+	{ 0.0f, 0.0f, 1.0f },
+	{ 1.0f, 1.0f, 0.0f },
+	{ 0.8f, 0.0f, 0.0f },
+	{ 0.0f, 0.8f, 0.0f },
+	{ 0.0f, 0.0f, 0.8f },
+	{ 0.8f, 0.8f, 0.0f }
+};
+
+// relative, of the in-frame Hi-Z, covers rounding of the plane
+// within a triangle, so a skipped one could never have written a pixel
+const float HiZMargin = 1e-4f;
+
+// pixel centers of the snapped bounding box along an axis
+UINT BoxCenters(float minP, float maxP)
+{
+	return static_cast<UINT>(maxP - minP) + 1;
+}
+
+CPURasterizer::TriangleSizes GetTriangleSize(UINT width, UINT height)
+{
+	UINT longSide = std::max(width, height);
+	UINT shortSide = std::min(width, height);
+	if (longSide <= 2)
+	{
+		return (longSide == 1)
+			? CPURasterizer::Size1x1
+			: (shortSide == 1)
+				? CPURasterizer::Size2x1
+				: CPURasterizer::Size2x2;
+	}
+
+	UINT size = CPURasterizer::SizeUpTo4;
+	for (UINT limit = 4;
+		limit < longSide && size < CPURasterizer::SizeLarger;
+		limit *= 2)
+	{
+		size++;
+	}
+
+	return static_cast<CPURasterizer::TriangleSizes>(size);
+}
+
+// the first pixel center of the bounding box, ToFixedPoint()
+// without rounding, since it is exact for pixel centers
+template <typename Setup>
+XMINT2 GetMicroOrigin(const Setup& t)
+{
+	const float scale = static_cast<float>(RasterizerKernels::SubpixelScale);
+
+	return
+	{
+		static_cast<INT>(t.minP.x * scale),
+		static_cast<INT>(t.minP.y * scale)
+	};
+}
+
+// at most 2x2 pixel centers within the tile, with the vertices close
+// enough to them for the 32 bit edge functions of the micro kernels
+template <typename Setup>
+bool IsMicroTriangle(
+	const Setup& t,
+	const XMFLOAT2& tileMinP,
+	const XMFLOAT2& tileMaxP)
+{
+	if (t.maxP.x - t.minP.x >= 2.0f || t.maxP.y - t.minP.y >= 2.0f
+		|| t.minP.x < tileMinP.x || t.minP.y < tileMinP.y
+		|| t.maxP.x >= tileMaxP.x + 1.0f || t.maxP.y >= tileMaxP.y + 1.0f)
+	{
+		return false;
+	}
+
+	XMINT2 originFixed = GetMicroOrigin(t);
+	for (const XMINT2* p : { &t.p0Fixed, &t.p1Fixed, &t.p2Fixed })
+	{
+		if (std::abs(p->x - originFixed.x) > RasterizerKernels::MicroMaxOffset
+			|| std::abs(p->y - originFixed.y)
+				> RasterizerKernels::MicroMaxOffset)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// into the next lane of the batch, offset is of the first pixel center
+template <typename Setup>
+void SetupMicroTriangle(
+	const Setup& t,
+	UINT offset,
+	RasterizerKernels::MicroTriangles& batch)
+{
+	UINT lane = batch.count++;
+	XMINT2 originFixed = GetMicroOrigin(t);
+	batch.x0[lane] = t.p0Fixed.x - originFixed.x;
+	batch.y0[lane] = t.p0Fixed.y - originFixed.y;
+	batch.x1[lane] = t.p1Fixed.x - originFixed.x;
+	batch.y1[lane] = t.p1Fixed.y - originFixed.y;
+	batch.x2[lane] = t.p2Fixed.x - originFixed.x;
+	batch.y2[lane] = t.p2Fixed.y - originFixed.y;
+	batch.p0x[lane] = t.p0SS.x;
+	batch.p0y[lane] = t.p0SS.y;
+	batch.p1x[lane] = t.p1SS.x;
+	batch.p1y[lane] = t.p1SS.y;
+	batch.p2x[lane] = t.p2SS.x;
+	batch.p2y[lane] = t.p2SS.y;
+	batch.originX[lane] = t.minP.x;
+	batch.originY[lane] = t.minP.y;
+	batch.z0[lane] = t.z0NDC;
+	batch.z1[lane] = t.z1NDC;
+	batch.z2[lane] = t.z2NDC;
+	batch.invArea[lane] = t.invArea;
+	batch.width[lane] = static_cast<INT>(BoxCenters(t.minP.x, t.maxP.x));
+	batch.height[lane] = static_cast<INT>(BoxCenters(t.minP.y, t.maxP.y));
+	batch.offset[lane] = offset;
+}
+
+// stable LSD radix sort by the 16 bit keys, 8 bits per pass
+template <typename Item>
+void RadixSort(std::vector<Item>& items, std::vector<Item>& scratch)
+{
+	scratch.resize(items.size());
+	for (UINT shift = 0; shift < 16; shift += 8)
+	{
+		UINT offsets[256] = {};
+		for (const Item& item : items)
+		{
+			offsets[(item.key >> shift) & 0xFF]++;
+		}
+
+		UINT offset = 0;
+		for (UINT& digitOffset : offsets)
+		{
+			UINT count = digitOffset;
+			digitOffset = offset;
+			offset += count;
+		}
+
+		for (const Item& item : items)
+		{
+			scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+		}
+		items.swap(scratch);
+	}
+}
+
+// starts from the default value, which is one of the values
+AutoTuner::Parameter TunedParameter(
+	const std::vector<UINT>& values,
+	UINT defaultValue)
+{
+	auto value = std::find(values.begin(), values.end(), defaultValue);
+	assert(value != values.end());
+
+	return { values, static_cast<UINT>(value - values.begin()) };
+}
+
+}
+
+CPURasterizer::CPURasterizer()
+	: _tuner(
+		{
+			TunedParameter(
+				{ 16, 32, 64, 128, 256, 512, 1024, 2048 },
+				DefaultBigTriangleThreshold),
+			TunedParameter(
+				{ 32, 64, 128, MaxTileSize },
+				DefaultTileSize)
+		})
+{
+	for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+	{
+		// fits either layout
+		_shadowMaps[cascade].resize(RasterizerKernels::TiledSize(
+			Settings::ShadowMapRes,
+			Settings::ShadowMapRes));
+
+		ViewParams& view = _views[1 + cascade];
+		view.width = Settings::ShadowMapRes;
+		view.height = Settings::ShadowMapRes;
+	}
+
+	UINT workersCount = _threadPool.GetWorkersCount();
+	_setups.resize(workersCount);
+	_meshletBounds.resize(workersCount);
+	_setupOffsets.resize(workersCount + 1);
+	for (auto& bins : _bins)
+	{
+		bins.resize(workersCount);
+	}
+	_stats.resize(workersCount);
+	_vertexCaches.resize(workersCount);
+	_visiblePixels.resize(workersCount);
+	for (auto& visiblePixels : _visiblePixels)
+	{
+		visiblePixels.resize(MaxTileSize * MaxTileSize);
+	}
+	_setTileSize(_tileSize);
+
+	SetKernels(RasterizerKernels::DetectBest());
+}
+
+void CPURasterizer::SetAutoTuning(bool enabled)
+{
+	_autoTuning = enabled;
+	if (_autoTuning)
+	{
+		_tuner.Restart();
+	}
+}
+
+void CPURasterizer::SetKernels(RasterizerKernels::Type type)
+{
+	assert(RasterizerKernels::IsSupported(type));
+
+	_kernels = &RasterizerKernels::Get(type);
+	Utils::PrintToOutput("CPU rasterizer kernels: %s\n", _kernels->name);
+}
+
+void CPURasterizer::SetTiledShadowMaps(bool enabled)
+{
+	for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+	{
+		_views[1 + cascade].tiled = enabled;
+	}
+}
+
+void CPURasterizer::SetHiZCulling(bool enabled)
+{
+	_HiZCullingEnabled = enabled;
+	// they would be of an older frame otherwise
+	ResetHiZ();
+}
+
+void CPURasterizer::Resize(UINT width, UINT height)
+{
+	_width = width;
+	_height = height;
+
+	_renderTarget.resize(_width * _height);
+	_depthBuffer.resize(_width * _height);
+	_visibilityBuffer.resize(_width * _height);
+	ResetHiZ();
+
+	ViewParams& view = _views[0];
+	view.width = _width;
+	view.height = _height;
+
+	// shared by the views, they are drawn one after another
+	size_t blocksCount = 0;
+	for (const ViewParams& params : _views)
+	{
+		const UINT BlockSize = RasterizerKernels::BlockSize;
+		blocksCount = std::max<size_t>(
+			blocksCount,
+			((params.width + BlockSize - 1) / BlockSize)
+				* ((params.height + BlockSize - 1) / BlockSize));
+	}
+	_inFrameHiZ.resize(blocksCount);
+
+	_setTileSize(_tileSize);
+}
+
+void CPURasterizer::_setTileSize(UINT tileSize)
+{
+	assert(tileSize <= MaxTileSize);
+
+	_tileSize = tileSize;
+
+	// the cascades follow each other, so they can be binned together,
+	// the camera reuses their bins
+	UINT cascadesBinsCount = 0;
+	for (UINT view = 0; view < Settings::FrustumsCount; view++)
+	{
+		ViewParams& params = _views[view];
+		params.tilesX = (params.width + _tileSize - 1) / _tileSize;
+		params.tilesY = (params.height + _tileSize - 1) / _tileSize;
+		params.firstBin = 0;
+		if (view > 0)
+		{
+			params.firstBin = cascadesBinsCount;
+			cascadesBinsCount += params.tilesX * params.tilesY;
+		}
+	}
+	size_t binsCount = std::max(
+		_views[0].tilesX * _views[0].tilesY,
+		cascadesBinsCount);
+	for (auto& pathBins : _bins)
+	{
+		for (auto& bins : pathBins)
+		{
+			bins.resize(binsCount);
+		}
+	}
+	for (auto& tiles : _compactedTriangles)
+	{
+		tiles.resize(_views[0].tilesX * _views[0].tilesY);
+	}
+}
+
+// mirrors SoftwareRasterization::Update
+void CPURasterizer::Update()
+{
+	if (_meshletsScene != Scene::CurrentScene)
+	{
+		_buildMeshlets();
+		ResetHiZ();
+	}
+
+	const Camera& camera = Scene::CurrentScene->camera;
+	_views[0].VP = camera.GetVP();
+	// z = w at the near plane with reversed Z, z = 0 otherwise
+	SetClipPlanes(
+		camera.ReverseZ()
+			? XMFLOAT4(0.0f, 0.0f, -1.0f, 1.0f)
+			: XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f),
+		_views[0].width,
+		_views[0].height,
+		_views[0].clipPlanes);
+
+	XMStoreFloat3(
+		&_sunDirection,
+		XMVector3Normalize(XMLoadFloat3(
+			&Scene::CurrentScene->lightDirection)));
+	for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+	{
+		_cascadeVP[cascade] =
+			ShadowsResources::Shadows.GetCascadeVP(cascade);
+		_cascadeBias[cascade] =
+			ShadowsResources::Shadows.GetCascadeBias(cascade);
+		_cascadeSplits[cascade] =
+			ShadowsResources::Shadows.GetCascadeSplit(cascade);
+
+		// orthographic, so w is always 1, casters in front of the near plane
+		// are kept, as in the GPU path
+		ViewParams& view = _views[1 + cascade];
+		view.VP = _cascadeVP[cascade];
+		SetClipPlanes(
+			XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f),
+			view.width,
+			view.height,
+			view.clipPlanes);
+	}
+	_showCascades = ShadowsResources::Shadows.ShowCascades();
+	_showMeshlets = Settings::ShowMeshlets;
+}
+
+void CPURasterizer::Draw(
+	const DrawList* drawLists,
+	UINT drawListsCount,
+	const DrawList* cascadesDrawList)
+{
+	assert(drawListsCount == Settings::FrustumsCount);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (auto& stats : _stats)
+	{
+		stats = {};
+	}
+
+	for (ViewParams& view : _views)
+	{
+		view.HiZ = nullptr;
+	}
+	if (_HiZCullingEnabled && _HiZBuilt)
+	{
+		for (UINT view = 0; view < Settings::FrustumsCount; view++)
+		{
+			// the view may have moved since, fitted cascades do
+			// even as the camera only turns
+			ViewParams& params = _views[view];
+			params.HiZ = &_HiZPyramids[view];
+			params.HiZSameVP = memcmp(
+				&params.VP,
+				&_HiZViewProjections[view],
+				sizeof(XMFLOAT4X4)) == 0;
+			XMStoreFloat4x4(
+				&params.HiZReprojection,
+				XMMatrixInverse(nullptr, XMLoadFloat4x4(&params.VP))
+					* XMLoadFloat4x4(&_HiZViewProjections[view]));
+		}
+	}
+
+	// shadows go first, since the opaque pass samples them
+	for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+	{
+		std::fill(
+			_shadowMaps[cascade].begin(),
+			_shadowMaps[cascade].end(),
+			0.0f);
+	}
+	if (cascadesDrawList)
+	{
+		// a triangle is fetched once for all the cascades drawing it
+		_binTriangles<true>(
+			&_views[1],
+			Settings::CascadesCount,
+			*cascadesDrawList);
+		for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+		{
+			_rasterizeDepth(_views[1 + cascade], _shadowMaps[cascade].data());
+		}
+	}
+	else
+	{
+		for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+		{
+			_binTriangles<true>(
+				&_views[1 + cascade],
+				1,
+				drawLists[1 + cascade]);
+			_rasterizeDepth(_views[1 + cascade], _shadowMaps[cascade].data());
+		}
+	}
+
+	// reversed Z
+	std::fill(_depthBuffer.begin(), _depthBuffer.end(), 0.0f);
+	std::fill(
+		_renderTarget.begin(),
+		_renderTarget.end(),
+		XMFLOAT4(SkyColor));
+
+	// camera bins are reused by the opaque pass,
+	// the setup is exactly the same, so are the depths
+	_binTriangles<false>(&_views[0], 1, drawLists[0]);
+	if (_visibilityBufferEnabled)
+	{
+		std::fill(_visibilityBuffer.begin(), _visibilityBuffer.end(), 0);
+		_rasterizeVisibilityBuffer(_views[0]);
+		_resolveVisibilityBuffer(drawLists[0]);
+	}
+	else
+	{
+		_rasterizeDepth(
+			_views[0],
+			_depthBuffer.data(),
+			nullptr,
+			_triangleCompactionEnabled ? _compactedTriangles : nullptr);
+
+		auto filterStart = std::chrono::high_resolution_clock::now();
+		_compactedTrianglesBytes = 0;
+		if (_triangleCompactionEnabled)
+		{
+			_filterCompactedTriangles();
+			for (const auto& tiles : _compactedTriangles)
+			{
+				for (const auto& triangles : tiles)
+				{
+					_compactedTrianglesBytes +=
+						triangles.capacity() * sizeof(CompactTriangle);
+				}
+			}
+		}
+
+		auto opaqueStart = std::chrono::high_resolution_clock::now();
+		_rasterizeOpaque(drawLists[0]);
+		auto opaqueFinish = std::chrono::high_resolution_clock::now();
+
+		_filterTimeMS = std::chrono::duration<float, std::milli>(
+			opaqueStart - filterStart).count();
+		_opaqueTimeMS = std::chrono::duration<float, std::milli>(
+			opaqueFinish - opaqueStart).count();
+	}
+
+	if (_HiZCullingEnabled)
+	{
+		for (UINT view = 0; view < Settings::FrustumsCount; view++)
+		{
+			const ViewParams& params = _views[view];
+			_HiZPyramids[view].Build(
+				_threadPool,
+				*_kernels,
+				(view == 0)
+					? _depthBuffer.data()
+					: _shadowMaps[view - 1].data(),
+				params.width,
+				params.height,
+				params.tiled);
+			_HiZViewProjections[view] = params.VP;
+		}
+		_HiZBuilt = true;
+	}
+	// the benchmarks draw the views again without it
+	for (ViewParams& view : _views)
+	{
+		view.HiZ = nullptr;
+	}
+
+	for (UINT stat = 0; stat < StatsCount; stat++)
+	{
+		_statsResult[stat] = 0;
+		for (const auto& stats : _stats)
+		{
+			_statsResult[stat] += stats.counts[stat];
+		}
+	}
+
+	for (UINT path = 0; path < PathsCount; path++)
+	{
+		PathStats total;
+		for (const auto& stats : _stats)
+		{
+			total.seconds += stats.paths[path].seconds;
+			total.pixels += stats.paths[path].pixels;
+		}
+		_pathMPixelsPerSecond[path] = (total.seconds > 0.0)
+			? static_cast<float>(1e-6 * total.pixels / total.seconds)
+			: 0.0f;
+	}
+
+	auto finish = std::chrono::high_resolution_clock::now();
+	_rasterizationTimeMS =
+		std::chrono::duration<float, std::milli>(finish - start).count();
+
+	if (_autoTuning)
+	{
+		_tune();
+	}
+}
+
+// the values are used starting from the next Draw()
+void CPURasterizer::_tune()
+{
+	bool converged = _tuner.IsConverged();
+
+	// of the configuration just measured
+	if (_tuner.AddFrame(_rasterizationTimeMS))
+	{
+		Utils::PrintToOutput(
+			"CPU rasterizer tuning: big triangle threshold %u, tile size %u, "
+			"%.3f ms, small / big triangles %.1f / %.1f Mpixels/s\n",
+			_bigTriangleThreshold,
+			_tileSize,
+			_tuner.GetCost(),
+			_pathMPixelsPerSecond[SmallTriangles],
+			_pathMPixelsPerSecond[BigTriangles]);
+	}
+
+	_bigTriangleThreshold = _tuner.GetValue(BigTriangleThresholdParameter);
+	if (_tuner.GetValue(TileSizeParameter) != _tileSize)
+	{
+		_setTileSize(_tuner.GetValue(TileSizeParameter));
+	}
+
+	if (!converged && _tuner.IsConverged())
+	{
+		Utils::PrintToOutput(
+			"CPU rasterizer tuning converged: big triangle threshold %u, "
+			"tile size %u, %.3f ms\n",
+			_bigTriangleThreshold,
+			_tileSize,
+			_tuner.GetCost());
+	}
+}
+
+void CPURasterizer::_buildMeshlets()
+{
+	const Scene& scene = *Scene::CurrentScene;
+	_meshletsScene = &scene;
+
+	_meshlets.resize(scene.meshesMetaCPU.size());
+	_meshletVertices.clear();
+	_meshletIndices.assign(scene.indicesCPU.size(), 0);
+
+	// of the current meshlet, reset after every one of them
+	std::vector<INT> slots(scene.positionsCPU.size(), -1);
+	for (UINT mesh = 0; mesh < scene.meshesMetaCPU.size(); mesh++)
+	{
+		const MeshMeta& meshMeta = scene.meshesMetaCPU[mesh];
+		Meshlet& meshlet = _meshlets[mesh];
+		meshlet.firstVertex = static_cast<UINT>(_meshletVertices.size());
+		meshlet.verticesCount = 0;
+
+		for (UINT index = 0; index < meshMeta.indexCountPerInstance; index++)
+		{
+			UINT indexLocation = meshMeta.startIndexLocation + index;
+			UINT vertex =
+				meshMeta.baseVertexLocation + scene.indicesCPU[indexLocation];
+			if (slots[vertex] < 0)
+			{
+				slots[vertex] = static_cast<INT>(meshlet.verticesCount++);
+				_meshletVertices.push_back(vertex);
+			}
+			_meshletIndices[indexLocation] = static_cast<UINT8>(slots[vertex]);
+		}
+
+		for (UINT vertex = meshlet.firstVertex;
+			vertex < _meshletVertices.size();
+			vertex++)
+		{
+			slots[_meshletVertices[vertex]] = -1;
+		}
+
+		// set up without the cache
+		if (meshlet.verticesCount > MaxCachedVertices)
+		{
+			_meshletVertices.resize(meshlet.firstVertex);
+			meshlet.verticesCount = 0;
+		}
+	}
+}
+
+// coarse front-to-back order of the draw list's instances,
+// by the view depth of their bounding spheres' centers
+void CPURasterizer::_sortInstances(
+	const ViewParams& view,
+	const DrawList& drawList)
+{
+	const Scene& scene = *Scene::CurrentScene;
+	XMMATRIX VP = XMLoadFloat4x4(&view.VP);
+
+	_sortedInstances.clear();
+	for (UINT commandIndex = 0;
+		commandIndex < drawList.commandsCount;
+		commandIndex++)
+	{
+		const IndirectCommand& command = drawList.commands[commandIndex];
+		for (UINT inst = 0; inst < command.arguments.InstanceCount; inst++)
+		{
+			UINT instanceIndex = command.startInstanceLocation + inst;
+			const Instance& instance = drawList.instances[instanceIndex];
+			const MeshMeta& meshMeta = scene.meshesMetaCPU[instance.meshID];
+
+			XMVECTOR centerWS = XMVector3Transform(
+				XMLoadFloat4(&meshMeta.boundingSphere),
+				XMLoadFloat4x4(&instance.worldTransform));
+			XMVECTOR centerCS = XMVector4Transform(centerWS, VP);
+
+			// reversed Z, centers behind the camera may still be
+			// in front of it with the rest of the sphere
+			float w = XMVectorGetW(centerCS);
+			float nearness = (w > 0.0f)
+				? std::clamp(XMVectorGetZ(centerCS) / w, 0.0f, 1.0f)
+				: 1.0f;
+
+			SortedInstance sorted;
+			sorted.key = FrontToBackKeyMax - static_cast<UINT>(
+				nearness * static_cast<float>(FrontToBackKeyMax));
+			sorted.commandIndex = commandIndex;
+			sorted.instanceIndex = instanceIndex;
+			_sortedInstances.push_back(sorted);
+		}
+	}
+
+	RadixSort(_sortedInstances, _sortedInstancesScratch);
+}
+
+template <bool Orthographic>
+void CPURasterizer::_binTriangles(
+	const ViewParams* views,
+	UINT viewsCount,
+	const DrawList& drawList)
+{
+	assert(viewsCount == 1 || drawList.viewsMasks);
+
+	for (UINT worker = 0; worker < _threadPool.GetWorkersCount(); worker++)
+	{
+		_setups[worker].clear();
+		_meshletBounds[worker].clear();
+		for (UINT view = 0; view < viewsCount; view++)
+		{
+			UINT firstBin = views[view].firstBin;
+			UINT tilesCount = views[view].tilesX * views[view].tilesY;
+			for (auto& bins : _bins)
+			{
+				for (UINT tile = 0; tile < tilesCount; tile++)
+				{
+					bins[worker][firstBin + tile].clear();
+				}
+			}
+		}
+	}
+
+	auto setupInstance = [&](
+		const IndirectCommand& command,
+		UINT instanceIndex,
+		UINT worker)
+	{
+		const auto& args = command.arguments;
+		const Instance& instance = drawList.instances[instanceIndex];
+		UINT viewsMask = drawList.viewsMasks
+			? drawList.viewsMasks[instanceIndex]
+			: 1;
+
+		if (_vertexCacheEnabled
+			&& _meshlets[instance.meshID].verticesCount > 0)
+		{
+			_setupMeshlet<Orthographic>(
+				views,
+				viewsMask,
+				instance,
+				instanceIndex,
+				args.StartIndexLocation,
+				args.IndexCountPerInstance,
+				worker);
+			return;
+		}
+
+		for (UINT index = 0; index < args.IndexCountPerInstance; index += 3)
+		{
+			_setupTriangle<Orthographic>(
+				views,
+				viewsMask,
+				instance,
+				instanceIndex,
+				args.StartIndexLocation + index,
+				args.BaseVertexLocation,
+				worker);
+		}
+	};
+
+	if (!_frontToBackEnabled)
+	{
+		_threadPool.ParallelFor(
+			drawList.commandsCount,
+			[&](UINT commandIndex, UINT worker)
+			{
+				const IndirectCommand& command =
+					drawList.commands[commandIndex];
+				for (UINT inst = 0;
+					inst < command.arguments.InstanceCount;
+					inst++)
+				{
+					setupInstance(
+						command,
+						command.startInstanceLocation + inst,
+						worker);
+				}
+			});
+	}
+	else
+	{
+		_sortInstances(views[0], drawList);
+
+		// a contiguous range of the sorted instances per task, which has
+		// its own setups and stats, as a worker otherwise does,
+		// tiles walk the setups in this order, so nearest first
+		UINT workersCount = _threadPool.GetWorkersCount();
+		UINT instancesCount = static_cast<UINT>(_sortedInstances.size());
+		_threadPool.ParallelFor(
+			workersCount,
+			[&](UINT range, UINT)
+			{
+				UINT first = static_cast<UINT>(
+					static_cast<UINT64>(instancesCount) * range / workersCount);
+				UINT last = static_cast<UINT>(
+					static_cast<UINT64>(instancesCount) * (range + 1)
+						/ workersCount);
+				for (UINT sorted = first; sorted < last; sorted++)
+				{
+					const SortedInstance& instance = _sortedInstances[sorted];
+					setupInstance(
+						drawList.commands[instance.commandIndex],
+						instance.instanceIndex,
+						range);
+				}
+			});
+	}
+
+	// 0 is for no triangle
+	_setupOffsets[0] = 1;
+	for (UINT worker = 0; worker < _setups.size(); worker++)
+	{
+		_setupOffsets[worker + 1] = _setupOffsets[worker]
+			+ static_cast<UINT>(_setups[worker].size());
+	}
+}
+
+// mirrors triangle setup of TriangleDepthCS,
+// the vertices are fetched and transformed to WS once for all the views
+template <bool Orthographic>
+void CPURasterizer::_setupTriangle(
+	const ViewParams* views,
+	UINT viewsMask,
+	const Instance& instance,
+	UINT instanceIndex,
+	UINT startIndexLocation,
+	INT baseVertexLocation,
+	UINT worker)
+{
+	const Scene& scene = *Scene::CurrentScene;
+
+	_stats[worker].counts[FetchedVertices] += 3;
+
+	TriangleSetup triangle;
+	triangle.i0 = scene.indicesCPU[startIndexLocation + 0];
+	triangle.i1 = scene.indicesCPU[startIndexLocation + 1];
+	triangle.i2 = scene.indicesCPU[startIndexLocation + 2];
+	triangle.baseVertexLocation = baseVertexLocation;
+	triangle.instanceIndex = instanceIndex;
+	triangle.meshletBounds = NoMeshletBounds;
+
+	// MS -> WS
+	XMMATRIX worldTransform = XMLoadFloat4x4(&instance.worldTransform);
+	const UINT indices[3] = { triangle.i0, triangle.i1, triangle.i2 };
+	XMFLOAT3* positionsWS[3] =
+	{
+		&triangle.p0WS,
+		&triangle.p1WS,
+		&triangle.p2WS
+	};
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		XMStoreFloat3(
+			positionsWS[vertex],
+			XMVector3Transform(
+				XMLoadFloat3(&scene.positionsCPU[
+					baseVertexLocation + indices[vertex]].position),
+				worldTransform));
+	}
+
+	_stats[worker].counts[TransformedVertices] += 3;
+
+	for (UINT view = 0; viewsMask != 0; view++, viewsMask >>= 1)
+	{
+		if ((viewsMask & 1) == 0)
+		{
+			continue;
+		}
+
+		// WS -> VS -> CS
+		XMMATRIX VP = XMLoadFloat4x4(&views[view].VP);
+		XMFLOAT4 positionsCS[3];
+		for (UINT vertex = 0; vertex < 3; vertex++)
+		{
+			XMStoreFloat4(
+				&positionsCS[vertex],
+				XMVector4Transform(
+					XMVectorSetW(XMLoadFloat3(positionsWS[vertex]), 1.0f),
+					VP));
+		}
+		_stats[worker].counts[TransformedVertices] += 3;
+
+		_projectTriangle<Orthographic>(
+			views[view],
+			triangle,
+			positionsCS,
+			worker);
+	}
+}
+
+// the post-transform cache, the meshlet's unique vertices are transformed
+// once per instance and view with the premultiplied MVP,
+// then its triangles are assembled from them
+template <bool Orthographic>
+void CPURasterizer::_setupMeshlet(
+	const ViewParams* views,
+	UINT viewsMask,
+	const Instance& instance,
+	UINT instanceIndex,
+	UINT startIndexLocation,
+	UINT indexCount,
+	UINT worker)
+{
+	const Scene& scene = *Scene::CurrentScene;
+	const Meshlet& meshlet = _meshlets[instance.meshID];
+	const MeshMeta& meshMeta = scene.meshesMetaCPU[instance.meshID];
+	assert(meshMeta.startIndexLocation == startIndexLocation);
+	VertexCache& cache = _vertexCaches[worker];
+	UINT* stats = _stats[worker].counts;
+
+	const UINT* vertices = &_meshletVertices[meshlet.firstVertex];
+	stats[FetchedVertices] += meshlet.verticesCount;
+
+	XMMATRIX worldTransform = XMLoadFloat4x4(&instance.worldTransform);
+
+	// only the opaque pass shades, so only it needs WS
+	if constexpr (!Orthographic)
+	{
+		for (UINT vertex = 0; vertex < meshlet.verticesCount; vertex++)
+		{
+			XMVECTOR positionMS = XMLoadFloat3(
+				&scene.positionsCPU[vertices[vertex]].position);
+			XMStoreFloat3(
+				&cache.positionsWS[vertex],
+				XMVector3Transform(positionMS, worldTransform));
+		}
+		stats[TransformedVertices] += meshlet.verticesCount;
+	}
+
+	UINT meshletBounds[Settings::FrustumsCount];
+	for (UINT view = 0; (viewsMask >> view) != 0; view++)
+	{
+		if ((viewsMask & (1 << view)) == 0)
+		{
+			continue;
+		}
+
+		XMMATRIX MVP = worldTransform * XMLoadFloat4x4(&views[view].VP);
+		for (UINT vertex = 0; vertex < meshlet.verticesCount; vertex++)
+		{
+			XMVECTOR positionMS = XMLoadFloat3(
+				&scene.positionsCPU[vertices[vertex]].position);
+			XMStoreFloat4(
+				&cache.positionsCS[view][vertex],
+				XMVector3Transform(positionMS, MVP));
+		}
+		stats[TransformedVertices] += meshlet.verticesCount;
+
+		meshletBounds[view] = _inFrameHiZEnabled
+			? _boundMeshlet(
+				views[view],
+				cache.positionsCS[view],
+				meshlet.verticesCount,
+				worker)
+			: NoMeshletBounds;
+	}
+
+	for (UINT index = 0; index < indexCount; index += 3)
+	{
+		UINT indexLocation = startIndexLocation + index;
+		const UINT8* slots = &_meshletIndices[indexLocation];
+
+		TriangleSetup triangle;
+		triangle.i0 = scene.indicesCPU[indexLocation + 0];
+		triangle.i1 = scene.indicesCPU[indexLocation + 1];
+		triangle.i2 = scene.indicesCPU[indexLocation + 2];
+		triangle.baseVertexLocation = meshMeta.baseVertexLocation;
+		triangle.instanceIndex = instanceIndex;
+		if constexpr (!Orthographic)
+		{
+			triangle.p0WS = cache.positionsWS[slots[0]];
+			triangle.p1WS = cache.positionsWS[slots[1]];
+			triangle.p2WS = cache.positionsWS[slots[2]];
+		}
+
+		for (UINT view = 0; (viewsMask >> view) != 0; view++)
+		{
+			if ((viewsMask & (1 << view)) == 0)
+			{
+				continue;
+			}
+
+			const XMFLOAT4 positionsCS[3] =
+			{
+				cache.positionsCS[view][slots[0]],
+				cache.positionsCS[view][slots[1]],
+				cache.positionsCS[view][slots[2]]
+			};
+			triangle.meshletBounds = meshletBounds[view];
+			_projectTriangle<Orthographic>(
+				views[view],
+				triangle,
+				positionsCS,
+				worker);
+		}
+	}
+}
+
+// screen bounds of the vertices of a meshlet, which bound its triangles
+// and their clipped pieces, unless some of them are behind the near plane
+UINT CPURasterizer::_boundMeshlet(
+	const ViewParams& view,
+	const XMFLOAT4* positionsCS,
+	UINT verticesCount,
+	UINT worker)
+{
+	XMFLOAT2 minNDC = { FLT_MAX, FLT_MAX };
+	XMFLOAT2 maxNDC = { -FLT_MAX, -FLT_MAX };
+	float maxZ = -FLT_MAX;
+	for (UINT vertex = 0; vertex < verticesCount; vertex++)
+	{
+		const XMFLOAT4& pCS = positionsCS[vertex];
+		if (pCS.w <= 0.0f || !IsInside(view.clipPlanes, 1, pCS))
+		{
+			return NoMeshletBounds;
+		}
+
+		float invW = 1.0f / pCS.w;
+		minNDC.x = std::min(minNDC.x, pCS.x * invW);
+		minNDC.y = std::min(minNDC.y, pCS.y * invW);
+		maxNDC.x = std::max(maxNDC.x, pCS.x * invW);
+		maxNDC.y = std::max(maxNDC.y, pCS.y * invW);
+		maxZ = std::max(maxZ, pCS.z * invW);
+	}
+
+	// NDC -> SS as in ProjectTriangle, y flips, a pixel more on every side
+	// covers snapping and rounding, clamped to the view
+	float width = static_cast<float>(view.width);
+	float height = static_cast<float>(view.height);
+	auto toPixel = [](float p, float size)
+	{
+		return static_cast<UINT>(std::clamp(p, 0.0f, size - 1.0f));
+	};
+
+	MeshletBounds bounds;
+	bounds.minX = toPixel((minNDC.x * 0.5f + 0.5f) * width - 1.0f, width);
+	bounds.minY = toPixel((maxNDC.y * -0.5f + 0.5f) * height - 1.0f, height);
+	bounds.maxX = toPixel((maxNDC.x * 0.5f + 0.5f) * width + 1.0f, width);
+	bounds.maxY = toPixel((minNDC.y * -0.5f + 0.5f) * height + 1.0f, height);
+	bounds.maxZ = maxZ;
+	_meshletBounds[worker].push_back(bounds);
+
+	return static_cast<UINT>(_meshletBounds[worker].size() - 1);
+}
+
+// triangle has the view independent part of the setup
+template <bool Orthographic>
+void CPURasterizer::_projectTriangle(
+	const ViewParams& view,
+	const TriangleSetup& triangle,
+	const XMFLOAT4* positionsCS,
+	UINT worker)
+{
+	// one more triangle attempted to be rendered
+	UINT* stats = _stats[worker].counts;
+	stats[PipelineTriangles]++;
+
+	const XMFLOAT4& p0CS = positionsCS[0];
+	const XMFLOAT4& p1CS = positionsCS[1];
+	const XMFLOAT4& p2CS = positionsCS[2];
+
+	// w is 1, so the near plane of w >= 0 never clips, and a triangle
+	// within the guard band needs neither clipping nor divides,
+	// the setup is exactly the same as the one of the general path
+	if constexpr (Orthographic)
+	{
+		if (IsInside(view.clipPlanes, ClipPlanesCount, p0CS)
+			&& IsInside(view.clipPlanes, ClipPlanesCount, p1CS)
+			&& IsInside(view.clipPlanes, ClipPlanesCount, p2CS))
+		{
+			TriangleSetup t;
+			RejectionReasons rejection;
+			if (!ProjectOrthographicTriangle(
+				p0CS,
+				p1CS,
+				p2CS,
+				static_cast<float>(view.width),
+				static_cast<float>(view.height),
+				t,
+				&rejection))
+			{
+				stats[RejectedTriangles + rejection]++;
+				return;
+			}
+			if (_isHiZOccluded(view, t, positionsCS))
+			{
+				stats[RejectedTriangles + HiZOccluded]++;
+				return;
+			}
+
+			stats[RenderedTriangles]++;
+			t.meshletBounds = triangle.meshletBounds;
+			_binSetup(view, t, worker);
+			return;
+		}
+	}
+
+	// near plane and guard band clipping,
+	// the clipped polygon is triangulated as a fan
+	ClipVertex polygon[MaxClippedVertices];
+	polygon[0] = { p0CS, { 1.0f, 0.0f, 0.0f } };
+	polygon[1] = { p1CS, { 0.0f, 1.0f, 0.0f } };
+	polygon[2] = { p2CS, { 0.0f, 0.0f, 1.0f } };
+	UINT verticesCount =
+		ClipTriangle(view.clipPlanes, ClipPlanesCount, polygon);
+
+	// the guard band planes can only cut off what is off screen anyway
+	RejectionReasons rejection = OffScreen;
+	if (verticesCount < 3
+		&& PlaneDistance(view.clipPlanes[0], p0CS) < 0.0f
+		&& PlaneDistance(view.clipPlanes[0], p1CS) < 0.0f
+		&& PlaneDistance(view.clipPlanes[0], p2CS) < 0.0f)
+	{
+		rejection = BehindCamera;
+	}
+
+	bool rendered = false;
+	for (UINT vertex = 2; vertex < verticesCount; vertex++)
+	{
+		TriangleSetup t = triangle;
+		RejectionReasons pieceRejection;
+		if (!ProjectTriangle(
+			polygon[0],
+			polygon[vertex - 1],
+			polygon[vertex],
+			static_cast<float>(view.width),
+			static_cast<float>(view.height),
+			t,
+			&pieceRejection))
+		{
+			if (vertex == 2)
+			{
+				rejection = pieceRejection;
+			}
+			continue;
+		}
+		if (_isHiZOccluded(view, t, positionsCS))
+		{
+			if (vertex == 2)
+			{
+				rejection = HiZOccluded;
+			}
+			continue;
+		}
+		rendered = true;
+
+		_binSetup(view, t, worker);
+	}
+
+	// one more triangle was rendered, even if split by clipping
+	if (rendered)
+	{
+		stats[RenderedTriangles]++;
+	}
+	else
+	{
+		stats[RejectedTriangles + rejection]++;
+	}
+}
+
+// by its pixel centers and the nearest and farthest of its vertices,
+// or by the rect of the whole triangle where the pyramid was drawn
+bool CPURasterizer::_isHiZOccluded(
+	const ViewParams& view,
+	const TriangleSetup& t,
+	const XMFLOAT4* positionsCS) const
+{
+	if (!view.HiZ)
+	{
+		return false;
+	}
+
+	if (!view.HiZSameVP)
+	{
+		XMMATRIX reprojection = XMLoadFloat4x4(&view.HiZReprojection);
+		XMFLOAT4 reprojectedCS[3];
+		for (UINT vertex = 0; vertex < 3; vertex++)
+		{
+			XMStoreFloat4(
+				&reprojectedCS[vertex],
+				XMVector4Transform(
+					XMLoadFloat4(&positionsCS[vertex]),
+					reprojection));
+		}
+
+		return view.HiZ->TestPoints(
+			_HiZTest,
+			reprojectedCS,
+			_countof(reprojectedCS)) == HiZPyramid::Occluded;
+	}
+
+	return view.HiZ->TestRect(
+		_HiZTest,
+		static_cast<UINT>(t.minP.x),
+		static_cast<UINT>(t.minP.y),
+		std::min(static_cast<UINT>(t.maxP.x), view.width - 1),
+		std::min(static_cast<UINT>(t.maxP.y), view.height - 1),
+		std::max({ t.z0NDC, t.z1NDC, t.z2NDC }),
+		std::min({ t.z0NDC, t.z1NDC, t.z2NDC }))
+		== HiZPyramid::Occluded;
+}
+
+// into the bins of the tiles it touches
+void CPURasterizer::_binSetup(
+	const ViewParams& view,
+	const TriangleSetup& t,
+	UINT worker)
+{
+	UINT setupIndex = static_cast<UINT>(_setups[worker].size());
+	_setups[worker].push_back(t);
+
+	UINT minTileX = static_cast<UINT>(t.minP.x) / _tileSize;
+	UINT minTileY = static_cast<UINT>(t.minP.y) / _tileSize;
+	UINT maxTileX = std::min(
+		static_cast<UINT>(t.maxP.x) / _tileSize,
+		view.tilesX - 1);
+	UINT maxTileY = std::min(
+		static_cast<UINT>(t.maxP.y) / _tileSize,
+		view.tilesY - 1);
+
+	// pixel centers of the bounding box, as dimensions of TriangleDepthCS,
+	// big triangles skip the tiles of their bounding box they miss
+	float boxPixels =
+		(t.maxP.x - t.minP.x + 1.0f) * (t.maxP.y - t.minP.y + 1.0f);
+	_stats[worker].counts[TriangleSizeCounts + GetTriangleSize(
+		BoxCenters(t.minP.x, t.maxP.x),
+		BoxCenters(t.minP.y, t.maxP.y))]++;
+	Paths path = (boxPixels >= static_cast<float>(_bigTriangleThreshold))
+		? BigTriangles
+		: SmallTriangles;
+	bool skipTiles = path == BigTriangles
+		&& (minTileX != maxTileX || minTileY != maxTileY);
+	for (UINT tileY = minTileY; tileY <= maxTileY; tileY++)
+	{
+		for (UINT tileX = minTileX; tileX <= maxTileX; tileX++)
+		{
+			if (skipTiles && ClassifyTile(t, tileX, tileY, _tileSize)
+				== RasterizerKernels::Outside)
+			{
+				continue;
+			}
+
+			UINT tile = tileY * view.tilesX + tileX;
+			_bins[path][worker][view.firstBin + tile].push_back(setupIndex);
+		}
+	}
+}
+
+// inclusive pixels of the tile within the view
+void CPURasterizer::_getTileRect(
+	const ViewParams& view,
+	UINT tile,
+	UINT rect[4]) const
+{
+	UINT tileX = tile % view.tilesX;
+	UINT tileY = tile / view.tilesX;
+	rect[0] = tileX * _tileSize;
+	rect[1] = tileY * _tileSize;
+	rect[2] = std::min((tileX + 1) * _tileSize, view.width) - 1;
+	rect[3] = std::min((tileY + 1) * _tileSize, view.height) - 1;
+}
+
+// tiles are multiples of blocks, so they own theirs
+void CPURasterizer::_resetHiZ(
+	const ViewParams& view,
+	const UINT tileRect[4],
+	float blockDepth)
+{
+	const UINT BlockSize = RasterizerKernels::BlockSize;
+	UINT blocksX = (view.width + BlockSize - 1) / BlockSize;
+	for (UINT blockY = tileRect[1] / BlockSize;
+		blockY <= tileRect[3] / BlockSize;
+		blockY++)
+	{
+		for (UINT blockX = tileRect[0] / BlockSize;
+			blockX <= tileRect[2] / BlockSize;
+			blockX++)
+		{
+			_inFrameHiZ[blockY * blocksX + blockX] = blockDepth;
+		}
+	}
+}
+
+// the farthest one of its pixels within the view
+float CPURasterizer::_getBlockDepth(
+	const ViewParams& view,
+	const float* depth,
+	UINT blockX,
+	UINT blockY) const
+{
+	const UINT BlockSize = RasterizerKernels::BlockSize;
+	UINT minX = blockX * BlockSize;
+	UINT minY = blockY * BlockSize;
+	UINT width = std::min(minX + BlockSize, view.width) - minX;
+	UINT height = std::min(minY + BlockSize, view.height) - minY;
+
+	// rows of a tiled block follow each other
+	const float* row = view.tiled
+		? depth + RasterizerKernels::TiledOffset(
+			minX,
+			minY,
+			RasterizerKernels::TiledBlocksCount(view.width))
+		: depth + minY * view.width + minX;
+	UINT pitch = view.tiled ? BlockSize : view.width;
+
+	float blockDepth = FLT_MAX;
+	for (UINT y = 0; y < height; y++, row += pitch)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			blockDepth = std::min(blockDepth, row[x]);
+		}
+	}
+
+	return blockDepth;
+}
+
+// if the blocks overlapping the inclusive pixel rect are all closer
+// than maxZ, the ones marked by partial writes are found again
+// from the depths, stops at the first one that is not
+bool CPURasterizer::_isOccluded(
+	const ViewParams& view,
+	const float* depth,
+	UINT minX,
+	UINT minY,
+	UINT maxX,
+	UINT maxY,
+	float maxZ)
+{
+	const UINT BlockSize = RasterizerKernels::BlockSize;
+	UINT blocksX = (view.width + BlockSize - 1) / BlockSize;
+	float occluderZ = maxZ / (1.0f - HiZMargin);
+	for (UINT blockY = minY / BlockSize; blockY <= maxY / BlockSize; blockY++)
+	{
+		for (UINT blockX = minX / BlockSize;
+			blockX <= maxX / BlockSize;
+			blockX++)
+		{
+			float& blockDepth = _inFrameHiZ[blockY * blocksX + blockX];
+			if (blockDepth < 0.0f)
+			{
+				blockDepth = _getBlockDepth(view, depth, blockX, blockY);
+			}
+
+			if (blockDepth <= occluderZ)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// after the triangle was drawn over the pixels of raster
+void CPURasterizer::_updateHiZ(
+	const ViewParams& view,
+	const RasterTriangle& raster,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height)
+{
+	const UINT BlockSize = RasterizerKernels::BlockSize;
+	UINT blocksX = (view.width + BlockSize - 1) / BlockSize;
+	UINT maxX = originX + width - 1;
+	UINT maxY = originY + height - 1;
+	for (UINT blockY = originY / BlockSize;
+		blockY <= maxY / BlockSize;
+		blockY++)
+	{
+		for (UINT blockX = originX / BlockSize;
+			blockX <= maxX / BlockSize;
+			blockX++)
+		{
+			// of the block within the view
+			UINT blockMinX = blockX * BlockSize;
+			UINT blockMinY = blockY * BlockSize;
+			UINT blockMaxX = std::min(blockMinX + BlockSize, view.width) - 1;
+			UINT blockMaxY = std::min(blockMinY + BlockSize, view.height) - 1;
+
+			UINT x0 = std::max(blockMinX, originX) - originX;
+			UINT y0 = std::max(blockMinY, originY) - originY;
+			UINT x1 = std::min(blockMaxX, maxX) - originX;
+			UINT y1 = std::min(blockMaxY, maxY) - originY;
+			RasterizerKernels::BlockCoverage coverage =
+				RasterizerKernels::ClassifyBlock(raster, x0, y0, x1, y1);
+			if (coverage == RasterizerKernels::Outside)
+			{
+				continue;
+			}
+
+			float& blockDepth = _inFrameHiZ[blockY * blocksX + blockX];
+			bool wholeBlock = blockMinX >= originX && blockMinY >= originY
+				&& blockMaxX <= maxX && blockMaxY <= maxY;
+			if (coverage == RasterizerKernels::Inside && wholeBlock)
+			{
+				// the plane is linear, so its corners bound it
+				using RasterizerKernels::PlaneDepth;
+				float fx0 = static_cast<float>(x0);
+				float fy0 = static_cast<float>(y0);
+				float fx1 = static_cast<float>(x1);
+				float fy1 = static_cast<float>(y1);
+				float minZ = std::min({
+					PlaneDepth(raster, fx0, fy0),
+					PlaneDepth(raster, fx1, fy0),
+					PlaneDepth(raster, fx0, fy1),
+					PlaneDepth(raster, fx1, fy1)
+				});
+				blockDepth = std::max(blockDepth, minZ);
+			}
+			else
+			{
+				blockDepth = -1.0f;
+			}
+		}
+	}
+}
+
+void CPURasterizer::_rasterizeDepth(
+	const ViewParams& view,
+	float* depth,
+	RasterizerKernels::DepthKernel kernel,
+	std::vector<std::vector<CompactTriangle>>* compactedTiles)
+{
+	// big triangles are the likely occluders of a tile, the max of depths
+	// is the same whatever the order is
+	const Paths PathsOrder[PathsCount] = { BigTriangles, SmallTriangles };
+
+	// the kernels given are row-major
+	assert(!kernel || !view.tiled);
+	UINT blocksX = RasterizerKernels::TiledBlocksCount(view.width);
+
+	_threadPool.ParallelFor(
+		view.tilesX * view.tilesY,
+		[&](UINT tile, UINT tileWorker)
+		{
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(
+				tile % view.tilesX,
+				tile / view.tilesX,
+				_tileSize,
+				tileMinP,
+				tileMaxP);
+			UINT tileRect[4];
+			_getTileRect(view, tile, tileRect);
+			UINT* counts = _stats[tileWorker].counts;
+
+			if (_inFrameHiZEnabled)
+			{
+				_resetHiZ(view, tileRect, 0.0f);
+			}
+
+			// triangles of a meshlet follow each other in a bin
+			const MeshletBounds* testedMeshlet = nullptr;
+			bool meshletOccluded = false;
+			auto isMeshletOccluded = [&](const MeshletBounds& bounds)
+			{
+				if (&bounds != testedMeshlet)
+				{
+					testedMeshlet = &bounds;
+					UINT minX = std::max(bounds.minX, tileRect[0]);
+					UINT minY = std::max(bounds.minY, tileRect[1]);
+					UINT maxX = std::min(bounds.maxX, tileRect[2]);
+					UINT maxY = std::min(bounds.maxY, tileRect[3]);
+					meshletOccluded = minX <= maxX && minY <= maxY
+						&& _isOccluded(
+							view,
+							depth,
+							minX, minY,
+							maxX, maxY,
+							bounds.maxZ);
+					counts[SkippedTileMeshlets] += meshletOccluded ? 1 : 0;
+				}
+
+				return meshletOccluded;
+			};
+
+			for (Paths path : PathsOrder)
+			{
+				RasterizerKernels::DepthKernel pathKernel = kernel
+					? kernel
+					: (path == BigTriangles)
+						? _kernels->depth
+						: RasterizerKernels::DepthSmall;
+				RasterizerKernels::TiledDepthKernel tiledKernel =
+					(path == BigTriangles)
+						? _kernels->tiledDepth
+						: RasterizerKernels::TiledDepthSmall;
+				PathStats& pathStats = _stats[tileWorker].paths[path];
+				auto start = std::chrono::high_resolution_clock::now();
+
+				if (compactedTiles)
+				{
+					compactedTiles[path][tile].clear();
+				}
+
+				// the kernels given are meant to see every triangle,
+				// offsets of a batch are row-major
+				bool microTriangles = _microTrianglesEnabled && !kernel
+					&& !view.tiled && path == SmallTriangles;
+				RasterizerKernels::MicroTriangles batch;
+				batch.count = 0;
+				auto flushBatch = [&]()
+				{
+					if (batch.count > 0)
+					{
+						_kernels->microDepth(batch, depth, view.width);
+						batch.count = 0;
+					}
+				};
+				// as the triangles below, but set up for the batch only
+				auto addMicroTriangle = [&](const TriangleSetup& t)
+				{
+					UINT rect[4];
+					rect[0] = static_cast<UINT>(t.minP.x);
+					rect[1] = static_cast<UINT>(t.minP.y);
+					rect[2] = rect[0] + BoxCenters(t.minP.x, t.maxP.x) - 1;
+					rect[3] = rect[1] + BoxCenters(t.minP.y, t.maxP.y) - 1;
+					if (_inFrameHiZEnabled
+						&& _isOccluded(
+							view,
+							depth,
+							rect[0], rect[1],
+							rect[2], rect[3],
+							std::max({ t.z0NDC, t.z1NDC, t.z2NDC })))
+					{
+						counts[SkippedTileTriangles]++;
+						return;
+					}
+
+					SetupMicroTriangle(
+						t,
+						rect[1] * view.width + rect[0],
+						batch);
+					if (batch.count == RasterizerKernels::MicroBatchSize)
+					{
+						flushBatch();
+					}
+					counts[MicroTriangleTiles]++;
+					pathStats.pixels +=
+						(rect[2] - rect[0] + 1) * (rect[3] - rect[1] + 1);
+
+					// written when the batch is flushed, so the blocks
+					// are found again from the depths
+					if (_inFrameHiZEnabled)
+					{
+						_resetHiZ(view, rect, -1.0f);
+					}
+
+					if (compactedTiles)
+					{
+						CompactTriangle compact;
+						SetupTileRaster(
+							t,
+							tileMinP,
+							tileMaxP,
+							compact.raster,
+							compact.originX, compact.originY,
+							compact.width, compact.height);
+						compact.setup = &t;
+						compactedTiles[path][tile].push_back(compact);
+					}
+				};
+
+				for (size_t worker = 0; worker < _setups.size(); worker++)
+				{
+					const auto& bin = _bins[path][worker][view.firstBin + tile];
+					for (UINT setupIndex : bin)
+					{
+						const TriangleSetup& t = _setups[worker][setupIndex];
+
+						if (_inFrameHiZEnabled
+							&& t.meshletBounds != NoMeshletBounds
+							&& isMeshletOccluded(
+								_meshletBounds[worker][t.meshletBounds]))
+						{
+							counts[SkippedTileTriangles]++;
+							continue;
+						}
+
+						if (microTriangles
+							&& IsMicroTriangle(t, tileMinP, tileMaxP))
+						{
+							addMicroTriangle(t);
+							continue;
+						}
+
+						RasterTriangle raster;
+						UINT originX, originY, width, height;
+						if (!SetupTileRaster(
+							t,
+							tileMinP,
+							tileMaxP,
+							raster,
+							originX, originY,
+							width, height))
+						{
+							continue;
+						}
+
+						if (_inFrameHiZEnabled
+							&& _isOccluded(
+								view,
+								depth,
+								originX,
+								originY,
+								originX + width - 1,
+								originY + height - 1,
+								std::max({ t.z0NDC, t.z1NDC, t.z2NDC })))
+						{
+							counts[SkippedTileTriangles]++;
+							continue;
+						}
+
+						// the tile is owned by this worker only
+						if (view.tiled)
+						{
+							tiledKernel(
+								raster,
+								originX, originY,
+								width, height,
+								depth,
+								blocksX);
+						}
+						else
+						{
+							pathKernel(
+								raster,
+								width,
+								height,
+								depth + originY * view.width + originX,
+								view.width);
+						}
+						pathStats.pixels += width * height;
+
+						if (_inFrameHiZEnabled)
+						{
+							_updateHiZ(
+								view,
+								raster,
+								originX, originY,
+								width, height);
+						}
+
+						if (compactedTiles)
+						{
+							CompactTriangle compact;
+							compact.raster = raster;
+							compact.setup = &t;
+							compact.originX = originX;
+							compact.originY = originY;
+							compact.width = width;
+							compact.height = height;
+							compactedTiles[path][tile].push_back(compact);
+						}
+					}
+				}
+				flushBatch();
+
+				auto finish = std::chrono::high_resolution_clock::now();
+				pathStats.seconds +=
+					std::chrono::duration<double>(finish - start).count();
+			}
+		});
+}
+
+// the filter stage between the passes, drops the triangles of a tile
+// behind its final depths, which the opaque pass would test in vain
+void CPURasterizer::_filterCompactedTriangles()
+{
+	const ViewParams& view = _views[0];
+
+	_threadPool.ParallelFor(
+		view.tilesX * view.tilesY,
+		[&](UINT tile, UINT tileWorker)
+		{
+			UINT tileRect[4];
+			_getTileRect(view, tile, tileRect);
+			// found again from the final depths as they are tested
+			_resetHiZ(view, tileRect, -1.0f);
+
+			for (auto& tiles : _compactedTriangles)
+			{
+				auto& triangles = tiles[tile];
+				size_t kept = 0;
+				for (const CompactTriangle& compact : triangles)
+				{
+					const TriangleSetup& t = *compact.setup;
+					if (_isOccluded(
+						view,
+						_depthBuffer.data(),
+						compact.originX,
+						compact.originY,
+						compact.originX + compact.width - 1,
+						compact.originY + compact.height - 1,
+						std::max({ t.z0NDC, t.z1NDC, t.z2NDC })))
+					{
+						_stats[tileWorker].counts[FilteredTriangles]++;
+						continue;
+					}
+					triangles[kept++] = compact;
+				}
+				triangles.resize(kept);
+				_stats[tileWorker].counts[CompactedTriangles] +=
+					static_cast<UINT>(kept);
+			}
+		});
+}
+
+void CPURasterizer::_rasterizeOpaque(const DrawList& drawList)
+{
+	const ViewParams& view = _views[0];
+
+	_threadPool.ParallelFor(
+		view.tilesX * view.tilesY,
+		[&](UINT tile, UINT tileWorker)
+		{
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(
+				tile % view.tilesX,
+				tile / view.tilesX,
+				_tileSize,
+				tileMinP,
+				tileMaxP);
+			UINT* visiblePixels = _visiblePixels[tileWorker].data();
+
+			for (UINT path = 0; path < PathsCount; path++)
+			{
+				RasterizerKernels::VisibilityKernel kernel =
+					(path == BigTriangles)
+						? _kernels->visibility
+						: RasterizerKernels::VisibilitySmall;
+				PathStats& pathStats = _stats[tileWorker].paths[path];
+				auto start = std::chrono::high_resolution_clock::now();
+
+				auto shadeTriangle = [&](
+					const TriangleSetup& t,
+					const RasterTriangle& raster,
+					UINT originX,
+					UINT originY,
+					UINT width,
+					UINT height)
+				{
+					// same depths as the depth pass,
+					// so early z test is exact
+					const float* tileDepth = _depthBuffer.data()
+						+ originY * view.width + originX;
+					UINT visibleCount = kernel(
+						raster,
+						width,
+						height,
+						tileDepth,
+						view.width,
+						visiblePixels);
+					pathStats.pixels += width * height;
+					if (visibleCount == 0)
+					{
+						return;
+					}
+
+					_stats[tileWorker].counts[ShadedPixels] += visibleCount;
+
+					const Instance& instance =
+						drawList.instances[t.instanceIndex];
+					TriangleAttributes attributes;
+					_fetchAttributes(t, attributes);
+
+					if (_attributePlanesEnabled)
+					{
+						AttributePlanes planes;
+						_setupAttributePlanes(t, attributes, raster, planes);
+						for (UINT pixel = 0; pixel < visibleCount; pixel++)
+						{
+							UINT x = visiblePixels[pixel] & 0xFFFF;
+							UINT y = visiblePixels[pixel] >> 16;
+							_renderTarget[
+								(originY + y) * view.width + originX + x] =
+								_shadePixel(
+									planes,
+									instance,
+									static_cast<float>(x),
+									static_cast<float>(y));
+						}
+						return;
+					}
+
+					for (UINT pixel = 0; pixel < visibleCount; pixel++)
+					{
+						UINT x = visiblePixels[pixel] & 0xFFFF;
+						UINT y = visiblePixels[pixel] >> 16;
+
+						float area0, area1, area2;
+						RasterizerKernels::EdgeFunctions(
+							raster,
+							static_cast<float>(x),
+							static_cast<float>(y),
+							area0, area1, area2);
+						float weight0, weight1, weight2;
+						RasterizerKernels::BarycentricWeights(
+							raster,
+							area0, area1,
+							weight0, weight1, weight2);
+
+						_renderTarget[
+							(originY + y) * view.width + originX + x] =
+							_shadePixel(
+								t,
+								attributes,
+								instance,
+								weight0,
+								weight1,
+								weight2);
+					}
+				};
+
+				if (_triangleCompactionEnabled)
+				{
+					// set up by the depth pass already
+					for (const CompactTriangle& compact
+						: _compactedTriangles[path][tile])
+					{
+						shadeTriangle(
+							*compact.setup,
+							compact.raster,
+							compact.originX,
+							compact.originY,
+							compact.width,
+							compact.height);
+					}
+				}
+				else
+				{
+					for (size_t worker = 0; worker < _setups.size(); worker++)
+					{
+						for (UINT setupIndex : _bins[path][worker][tile])
+						{
+							const TriangleSetup& t =
+								_setups[worker][setupIndex];
+
+							RasterTriangle raster;
+							UINT originX, originY, width, height;
+							if (!SetupTileRaster(
+								t,
+								tileMinP,
+								tileMaxP,
+								raster,
+								originX, originY,
+								width, height))
+							{
+								continue;
+							}
+
+							shadeTriangle(
+								t,
+								raster,
+								originX, originY,
+								width, height);
+						}
+					}
+				}
+
+				auto finish = std::chrono::high_resolution_clock::now();
+				pathStats.seconds +=
+					std::chrono::duration<double>(finish - start).count();
+			}
+		});
+}
+
+void CPURasterizer::_rasterizeVisibilityBuffer(const ViewParams& view)
+{
+	_threadPool.ParallelFor(
+		view.tilesX * view.tilesY,
+		[&](UINT tile, UINT tileWorker)
+		{
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(
+				tile % view.tilesX,
+				tile / view.tilesX,
+				_tileSize,
+				tileMinP,
+				tileMaxP);
+
+			for (UINT path = 0; path < PathsCount; path++)
+			{
+				RasterizerKernels::VisibilityBufferKernel kernel =
+					(path == BigTriangles)
+						? _kernels->visibilityBuffer
+						: RasterizerKernels::VisibilityBufferSmall;
+				PathStats& pathStats = _stats[tileWorker].paths[path];
+				auto start = std::chrono::high_resolution_clock::now();
+
+				for (size_t worker = 0; worker < _setups.size(); worker++)
+				{
+					for (UINT setupIndex : _bins[path][worker][tile])
+					{
+						const TriangleSetup& t = _setups[worker][setupIndex];
+
+						RasterTriangle raster;
+						UINT originX, originY, width, height;
+						if (!SetupTileRaster(
+							t,
+							tileMinP,
+							tileMaxP,
+							raster,
+							originX, originY,
+							width, height))
+						{
+							continue;
+						}
+
+						// the tile is owned by this worker only
+						kernel(
+							raster,
+							width,
+							height,
+							_setupOffsets[worker] + setupIndex,
+							_visibilityBuffer.data()
+								+ originY * view.width + originX,
+							view.width);
+						pathStats.pixels += width * height;
+					}
+				}
+
+				auto finish = std::chrono::high_resolution_clock::now();
+				pathStats.seconds +=
+					std::chrono::duration<double>(finish - start).count();
+			}
+		});
+}
+
+// shades every covered pixel once, the triangle is set up for the tile
+// the same way as in the opaque pass, so are the weights
+void CPURasterizer::_resolveVisibilityBuffer(const DrawList& drawList)
+{
+	const ViewParams& view = _views[0];
+
+	_threadPool.ParallelFor(
+		view.tilesX * view.tilesY,
+		[&](UINT tile, UINT tileWorker)
+		{
+			UINT tileX = tile % view.tilesX;
+			UINT tileY = tile / view.tilesX;
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(tileX, tileY, _tileSize, tileMinP, tileMaxP);
+			UINT minX = tileX * _tileSize;
+			UINT minY = tileY * _tileSize;
+			UINT maxX = std::min(minX + _tileSize, view.width);
+			UINT maxY = std::min(minY + _tileSize, view.height);
+
+			// neighbouring pixels mostly belong to the same triangle
+			UINT lastID = 0;
+			const TriangleSetup* t = nullptr;
+			RasterTriangle raster;
+			UINT originX = 0;
+			UINT originY = 0;
+			TriangleAttributes attributes;
+			AttributePlanes planes;
+			UINT* counts = _stats[tileWorker].counts;
+
+			for (UINT y = minY; y < maxY; y++)
+			{
+				for (UINT x = minX; x < maxX; x++)
+				{
+					UINT pixel = y * view.width + x;
+					UINT64 visibility = _visibilityBuffer[pixel];
+					_depthBuffer[pixel] =
+						RasterizerKernels::UnpackVisibilityDepth(visibility);
+					UINT id = RasterizerKernels::UnpackVisibilityID(visibility);
+					if (id == 0)
+					{
+						continue;
+					}
+
+					if (id != lastID)
+					{
+						t = &_getSetup(id);
+						UINT width, height;
+						SetupTileRaster(
+							*t,
+							tileMinP,
+							tileMaxP,
+							raster,
+							originX, originY,
+							width, height);
+						_fetchAttributes(*t, attributes);
+						if (_attributePlanesEnabled)
+						{
+							_setupAttributePlanes(
+								*t,
+								attributes,
+								raster,
+								planes);
+						}
+						lastID = id;
+					}
+					counts[ShadedPixels]++;
+
+					const Instance& instance =
+						drawList.instances[t->instanceIndex];
+					if (_attributePlanesEnabled)
+					{
+						_renderTarget[pixel] = _shadePixel(
+							planes,
+							instance,
+							static_cast<float>(x - originX),
+							static_cast<float>(y - originY));
+						continue;
+					}
+
+					float area0, area1, area2;
+					RasterizerKernels::EdgeFunctions(
+						raster,
+						static_cast<float>(x - originX),
+						static_cast<float>(y - originY),
+						area0, area1, area2);
+					float weight0, weight1, weight2;
+					RasterizerKernels::BarycentricWeights(
+						raster,
+						area0, area1,
+						weight0, weight1, weight2);
+
+					_renderTarget[pixel] = _shadePixel(
+						*t,
+						attributes,
+						instance,
+						weight0,
+						weight1,
+						weight2);
+				}
+			}
+		});
+}
+
+const CPURasterizer::TriangleSetup& CPURasterizer::_getSetup(UINT id) const
+{
+	// the last worker starting at or before the id,
+	// workers with no setups start at the same id as the next one
+	auto offset = std::upper_bound(
+		_setupOffsets.begin(),
+		_setupOffsets.end(),
+		id) - 1;
+	size_t worker = offset - _setupOffsets.begin();
+
+	return _setups[worker][id - *offset];
+}
+
+void CPURasterizer::_fetchAttributes(
+	const TriangleSetup& t,
+	TriangleAttributes& attributes) const
+{
+	const Scene& scene = *Scene::CurrentScene;
+	UINT indices[3] = { t.i0, t.i1, t.i2 };
+
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		UINT index = t.baseVertexLocation + indices[vertex];
+
+		XMStoreFloat3(
+			&attributes.normals[vertex],
+			UnpackNormal(scene.normalsCPU[index].packedNormal));
+		XMStoreFloat3(
+			&attributes.colors[vertex],
+			UnpackColor(scene.colorsCPU[index].packedColor));
+	}
+}
+
+// mirrors shading of TriangleOpaqueCS
+XMFLOAT4 CPURasterizer::_shadePixel(
+	const TriangleSetup& t,
+	const TriangleAttributes& attributes,
+	const Instance& instance,
+	float weight0,
+	float weight1,
+	float weight2) const
+{
+	// for perspective-correct interpolation
+	float denom = 1.0f / (
+		weight0 * t.invW0 +
+		weight1 * t.invW1 +
+		weight2 * t.invW2);
+	float w0 = denom * weight0 * t.invW0;
+	float w1 = denom * weight1 * t.invW1;
+	float w2 = denom * weight2 * t.invW2;
+
+	// back to the weights within the original triangle if it was clipped
+	XMFLOAT3 weights;
+	XMStoreFloat3(
+		&weights,
+		w0 * XMLoadFloat3(&t.barycentrics0) +
+		w1 * XMLoadFloat3(&t.barycentrics1) +
+		w2 * XMLoadFloat3(&t.barycentrics2));
+	w0 = weights.x;
+	w1 = weights.y;
+	w2 = weights.z;
+
+	XMVECTOR N = XMVector3Normalize(
+		w0 * XMLoadFloat3(&attributes.normals[0]) +
+		w1 * XMLoadFloat3(&attributes.normals[1]) +
+		w2 * XMLoadFloat3(&attributes.normals[2]));
+
+	XMVECTOR color =
+		w0 * XMLoadFloat3(&attributes.colors[0]) +
+		w1 * XMLoadFloat3(&attributes.colors[1]) +
+		w2 * XMLoadFloat3(&attributes.colors[2]);
+
+	XMVECTOR positionWS =
+		w0 * XMLoadFloat3(&t.p0WS) +
+		w1 * XMLoadFloat3(&t.p1WS) +
+		w2 * XMLoadFloat3(&t.p2WS);
+
+	return _shade(N, color, positionWS, denom, instance);
+}
+
+// weights of a pixel are linear in screen space, so are the attributes
+// of the clipped vertices, which are weighted the same way, divided by w
+void CPURasterizer::_setupAttributePlanes(
+	const TriangleSetup& t,
+	const TriangleAttributes& attributes,
+	const RasterTriangle& raster,
+	AttributePlanes& planes) const
+{
+	// a + (area0 * d0 + area1 * d1) * invArea, as the depth plane
+	auto setupPlane = [&](
+		XMVECTOR a0,
+		XMVECTOR a1,
+		XMVECTOR a2,
+		XMFLOAT3& a,
+		XMFLOAT3& dx,
+		XMFLOAT3& dy)
+	{
+		XMVECTOR d0 = (a0 - a2) * raster.invArea;
+		XMVECTOR d1 = (a1 - a2) * raster.invArea;
+		XMStoreFloat3(&a, a2 + raster.area0 * d0 + raster.area1 * d1);
+		XMStoreFloat3(&dx, -(raster.dxdy0.y * d0 + raster.dxdy1.y * d1));
+		XMStoreFloat3(&dy, raster.dxdy0.x * d0 + raster.dxdy1.x * d1);
+	};
+
+	const XMFLOAT3* barycentrics[3] =
+	{
+		&t.barycentrics0,
+		&t.barycentrics1,
+		&t.barycentrics2
+	};
+	const float invW[3] = { t.invW0, t.invW1, t.invW2 };
+	const XMFLOAT3 positionsWS[3] = { t.p0WS, t.p1WS, t.p2WS };
+
+	// of the clipped vertices, divided by w
+	XMVECTOR values[InterpolatedAttributesCount][3];
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		const XMFLOAT3& b = *barycentrics[vertex];
+		auto weigh = [&](const XMFLOAT3* vertexAttributes)
+		{
+			return invW[vertex] * (
+				b.x * XMLoadFloat3(&vertexAttributes[0]) +
+				b.y * XMLoadFloat3(&vertexAttributes[1]) +
+				b.z * XMLoadFloat3(&vertexAttributes[2]));
+		};
+		values[NormalAttribute][vertex] = weigh(attributes.normals);
+		values[ColorAttribute][vertex] = weigh(attributes.colors);
+		values[PositionWSAttribute][vertex] = weigh(positionsWS);
+	}
+
+	for (UINT attribute = 0;
+		attribute < InterpolatedAttributesCount;
+		attribute++)
+	{
+		setupPlane(
+			values[attribute][0],
+			values[attribute][1],
+			values[attribute][2],
+			planes.attributes[attribute],
+			planes.attributesDx[attribute],
+			planes.attributesDy[attribute]);
+	}
+
+	XMFLOAT3 invWPlane, invWDx, invWDy;
+	setupPlane(
+		XMVectorReplicate(t.invW0),
+		XMVectorReplicate(t.invW1),
+		XMVectorReplicate(t.invW2),
+		invWPlane,
+		invWDx,
+		invWDy);
+	planes.invW = invWPlane.x;
+	planes.invWDx = invWDx.x;
+	planes.invWDy = invWDy.x;
+}
+
+// a divide for w, the rest are multiply-adds
+XMFLOAT4 CPURasterizer::_shadePixel(
+	const AttributePlanes& planes,
+	const Instance& instance,
+	float x,
+	float y) const
+{
+	float viewDepth =
+		1.0f / (planes.invW + x * planes.invWDx + y * planes.invWDy);
+
+	auto evaluate = [&](UINT attribute)
+	{
+		return XMLoadFloat3(&planes.attributes[attribute]) +
+			x * XMLoadFloat3(&planes.attributesDx[attribute]) +
+			y * XMLoadFloat3(&planes.attributesDy[attribute]);
+	};
+
+	// w scales the length only
+	XMVECTOR N = XMVector3Normalize(evaluate(NormalAttribute));
+	XMVECTOR color = evaluate(ColorAttribute) * viewDepth;
+	XMVECTOR positionWS = evaluate(PositionWSAttribute) * viewDepth;
+
+	return _shade(N, color, positionWS, viewDepth, instance);
+}
+
+// mirrors shading of TriangleOpaqueCS from the interpolated attributes
+XMFLOAT4 CPURasterizer::_shade(
+	FXMVECTOR normal,
+	FXMVECTOR color,
+	FXMVECTOR positionWS,
+	float viewDepth,
+	const Instance& instance) const
+{
+	XMVECTOR albedo = _showMeshlets ? XMLoadFloat3(&instance.color) : color;
+
+	float NdotL = std::clamp(
+		XMVectorGetX(XMVector3Dot(XMLoadFloat3(&_sunDirection), normal)),
+		0.0f,
+		1.0f);
+	float shadow = _getShadow(viewDepth, positionWS);
+	XMVECTOR ambient = 0.2f * XMVectorSet(
+		SkyColor[0],
+		SkyColor[1],
+		SkyColor[2],
+		0.0f);
+
+	if (_showCascades)
+	{
+		albedo = XMLoadFloat3(
+			&CascadeColors[GetCascadeIndex(viewDepth, _cascadeSplits)]);
+	}
+
+	XMFLOAT4 result;
+	XMStoreFloat4(
+		&result,
+		XMVectorSetW(
+			albedo * (XMVectorReplicate(NdotL * shadow) + ambient),
+			1.0f));
+
+	return result;
+}
+
+// mirrors GetShadow of Common.hlsli, point clamp sampling
+float CPURasterizer::_getShadow(
+	float viewDepth,
+	FXMVECTOR positionWS) const
+{
+	UINT cascadeIdx = GetCascadeIndex(viewDepth, _cascadeSplits);
+
+	XMFLOAT4 positionLCS;
+	XMStoreFloat4(
+		&positionLCS,
+		XMVector4Transform(
+			XMVectorSetW(positionWS, 1.0f),
+			XMLoadFloat4x4(&_cascadeVP[cascadeIdx])));
+	float u = positionLCS.x * 0.5f + 0.5f;
+	float v = positionLCS.y * -0.5f + 0.5f;
+
+	const float res = static_cast<float>(Settings::ShadowMapRes);
+	UINT x = static_cast<UINT>(
+		std::clamp(std::floor(u * res), 0.0f, res - 1.0f));
+	UINT y = static_cast<UINT>(
+		std::clamp(std::floor(v * res), 0.0f, res - 1.0f));
+	UINT texel = _views[1 + cascadeIdx].tiled
+		? RasterizerKernels::TiledOffset(
+			x,
+			y,
+			RasterizerKernels::TiledBlocksCount(Settings::ShadowMapRes))
+		: y * Settings::ShadowMapRes + x;
+	float depthSM = _shadowMaps[cascadeIdx][texel];
+
+	return (positionLCS.z > (depthSM - _cascadeBias[cascadeIdx]))
+		? 1.0f
+		: 0.0f;
+}
\ No newline at end of file
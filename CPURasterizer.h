@@ -0,0 +1,665 @@
+#pragma once
+
+#include "Types.h"
+#include "Settings.h"
+#include "ThreadPool.h"
+#include "RasterizerKernels.h"
+#include "HiZPyramid.h"
+#include "AutoTuner.h"
+
+#include <array>
+#include <vector>
+
+class Scene;
+
+// CPU backend of the software rasterizer,
+// consumes the same Scene buffers and IndirectCommand lists as the GPU path
+// and follows TriangleDepthCS/TriangleOpaqueCS math,
+// so the result is expected to match it up to float precision,
+// except for pixels on shared edges, which are covered once
+// by the top-left rule here, and triangles crossing the near plane,
+// which are clipped here instead of being dropped
+//
+// triangles are set up and binned into screen tiles in parallel over
+// commands, then the tiles are rasterized in parallel, every tile is owned
+// by a single worker at a time, so no atomics are needed for depth writes
+//
+// the camera is either drawn with the depth and opaque passes,
+// or rasterized once into a visibility buffer of packed depths
+// and triangle ids, which is then shaded once per pixel
+//
+// as in the GPU path, triangles with a bounding box of the big triangle
+// threshold pixels or more take the big triangle path, which skips
+// the tiles and blocks they miss, the rest are tested per pixel,
+// both the threshold and the tile size can be tuned online
+class CPURasterizer
+{
+public:
+
+	// what to draw for a single view
+	struct DrawList
+	{
+		const IndirectCommand* commands = nullptr;
+		UINT commandsCount = 0;
+		// indexed with command's startInstanceLocation
+		const Instance* instances = nullptr;
+		// for a list of several views, a bit per view drawing the instance,
+		// indexed the same way as instances
+		const UINT* viewsMasks = nullptr;
+	};
+
+	// defaults are the same as the big triangle threshold
+	// and tile size of the GPU path
+	static const UINT DefaultBigTriangleThreshold = 64;
+	static const UINT DefaultTileSize = 128;
+	static const UINT MaxTileSize = 256;
+
+	// why a triangle of the pipeline was not rendered,
+	// a clipped one is counted by the first piece that failed
+	enum RejectionReasons
+	{
+		// entirely behind the near plane, which covers w <= 0
+		BehindCamera,
+		BackFacing,
+		// outside the frustum or the guard band
+		OffScreen,
+		// covers no pixel center
+		BetweenPixelCenters,
+		// behind the Hi-Z of the previous Draw(), see SetHiZCulling,
+		// the occluded triangles of a tile are skipped as well,
+		// see GetSkippedTileTrianglesCount
+		HiZOccluded,
+		RejectionReasonsCount
+	};
+
+	// by pixel centers of a triangle's bounding box, the longer side first,
+	// the first three take the micro triangle path if it is enabled
+	enum TriangleSizes
+	{
+		Size1x1,
+		Size2x1,
+		Size2x2,
+		SizeUpTo4,
+		SizeUpTo8,
+		SizeUpTo16,
+		SizeUpTo32,
+		SizeLarger,
+		TriangleSizesCount
+	};
+
+	CPURasterizer();
+	CPURasterizer(const CPURasterizer&) = delete;
+	CPURasterizer& operator=(const CPURasterizer&) = delete;
+	~CPURasterizer() = default;
+
+	void Resize(UINT width, UINT height);
+	void Update();
+	// [0] - camera, [1 + cascade] - cascades,
+	// cascadesDrawList replaces the cascade ones if given, its triangles
+	// are fetched once for all the cascades in their viewsMasks
+	void Draw(
+		const DrawList* drawLists,
+		UINT drawListsCount,
+		const DrawList* cascadesDrawList = nullptr);
+
+	UINT GetWidth() const { return _width; }
+	UINT GetHeight() const { return _height; }
+	const std::vector<DirectX::XMFLOAT4>& GetRenderTarget() const
+	{
+		return _renderTarget;
+	}
+	const std::vector<float>& GetDepthBuffer() const { return _depthBuffer; }
+
+	UINT GetPipelineTrianglesCount() const
+	{
+		return _statsResult[PipelineTriangles];
+	}
+	UINT GetRenderedTrianglesCount() const
+	{
+		return _statsResult[RenderedTriangles];
+	}
+	// 3 per triangle of every draw list, however many views draw it,
+	// or the unique ones of its meshlet with the vertex cache
+	UINT GetFetchedVerticesCount() const
+	{
+		return _statsResult[FetchedVertices];
+	}
+	// to WS and to CS, each counts
+	UINT GetTransformedVerticesCount() const
+	{
+		return _statsResult[TransformedVertices];
+	}
+	UINT GetRejectedTrianglesCount(RejectionReasons reason) const
+	{
+		return _statsResult[RejectedTriangles + reason];
+	}
+	// triangles not rasterized into a tile they were binned to,
+	// since the in-frame Hi-Z had it covered closer already
+	UINT GetSkippedTileTrianglesCount() const
+	{
+		return _statsResult[SkippedTileTriangles];
+	}
+	// of them, the ones skipped with their whole meshlet
+	UINT GetSkippedTileMeshletsCount() const
+	{
+		return _statsResult[SkippedTileMeshlets];
+	}
+	// triangles of camera tiles passed from the depth pass
+	// to the opaque one, and the ones the filter stage dropped
+	UINT GetCompactedTrianglesCount() const
+	{
+		return _statsResult[CompactedTriangles];
+	}
+	UINT GetFilteredTrianglesCount() const
+	{
+		return _statsResult[FilteredTriangles];
+	}
+	// by the opaque pass or the visibility buffer resolve
+	UINT GetShadedPixelsCount() const
+	{
+		return _statsResult[ShadedPixels];
+	}
+	// triangles set up for every view, however many tiles they touch
+	UINT GetTriangleSizesCount(TriangleSizes size) const
+	{
+		return _statsResult[TriangleSizeCounts + size];
+	}
+	// triangle tiles rasterized in batches by the micro triangle path
+	UINT GetMicroTrianglesCount() const
+	{
+		return _statsResult[MicroTriangleTiles];
+	}
+	UINT GetWorkersCount() const { return _threadPool.GetWorkersCount(); }
+	const char* GetKernelsName() const { return _kernels->name; }
+	void SetKernels(RasterizerKernels::Type type);
+	// of the last Draw()
+	float GetRasterizationTimeMS() const { return _rasterizationTimeMS; }
+	float GetFilterTimeMS() const { return _filterTimeMS; }
+	float GetOpaqueTimeMS() const { return _opaqueTimeMS; }
+	size_t GetCompactedTrianglesBytes() const
+	{
+		return _compactedTrianglesBytes;
+	}
+
+	// single raster pass for the camera instead of the depth and opaque ones
+	void SetVisibilityBuffer(bool enabled)
+	{
+		_visibilityBufferEnabled = enabled;
+	}
+	bool IsVisibilityBuffer() const { return _visibilityBufferEnabled; }
+
+	// transforms the unique vertices of a meshlet once per instance and view,
+	// instead of the 3 vertices of every triangle
+	void SetVertexCache(bool enabled) { _vertexCacheEnabled = enabled; }
+	bool IsVertexCache() const { return _vertexCacheEnabled; }
+
+	// sets up the instances nearest first by their bounding spheres,
+	// so the in-frame Hi-Z has the occluders before what they hide
+	void SetFrontToBack(bool enabled) { _frontToBackEnabled = enabled; }
+	bool IsFrontToBack() const { return _frontToBackEnabled; }
+
+	// depth tiles keep the farthest depth of every block of pixels
+	// as they fill, and skip triangles and whole meshlets behind it
+	// before walking their edges, unlike the GPU path's Hi-Z,
+	// which is of the previous frame
+	void SetInFrameHiZ(bool enabled) { _inFrameHiZEnabled = enabled; }
+	bool IsInFrameHiZ() const { return _inFrameHiZEnabled; }
+
+	// the camera's depth pass keeps the triangles it drew per tile
+	// with their raster setup, a filter stage drops the ones behind
+	// the final depths, and the opaque pass shades the rest
+	// without going through the bins again
+	void SetTriangleCompaction(bool enabled)
+	{
+		_triangleCompactionEnabled = enabled;
+	}
+	bool IsTriangleCompaction() const { return _triangleCompactionEnabled; }
+
+	// the opaque pass sets up plane equations of attributes / w
+	// once per triangle and tile, so a pixel evaluates them
+	// instead of its barycentric weights and the attributes of each vertex
+	void SetAttributePlanes(bool enabled) { _attributePlanesEnabled = enabled; }
+	bool IsAttributePlanes() const { return _attributePlanesEnabled; }
+
+	// depth passes rasterize the triangles of at most 2x2 pixel centers
+	// in batches, a triangle per SIMD lane, testing their pixel centers
+	// directly instead of setting up their edges for the kernels
+	void SetMicroTriangles(bool enabled) { _microTrianglesEnabled = enabled; }
+	bool IsMicroTriangles() const { return _microTrianglesEnabled; }
+
+	// cascades are rasterized into shadow maps tiled into the blocks
+	// of the kernels and the in-frame Hi-Z, see TiledOffset,
+	// the camera's targets stay row-major, since the opaque pass
+	// and the visibility buffer read them by rows
+	void SetTiledShadowMaps(bool enabled);
+	bool IsTiledShadowMaps() const { return _views[1].tiled; }
+
+	// keeps a min/max Hi-Z pyramid of the depths of every view at the end
+	// of Draw(), the next one drops the triangles behind it before binning,
+	// reprojected to the VP it was drawn with if the view moved since,
+	// so a triangle hidden by the last frame's depths only is missed
+	void SetHiZCulling(bool enabled);
+	bool IsHiZCulling() const { return _HiZCullingEnabled; }
+	void SetHiZTest(HiZPyramid::Tests test) { _HiZTest = test; }
+	HiZPyramid::Tests GetHiZTest() const { return _HiZTest; }
+	// so the next Draw() has none to cull against, e.g. on a camera cut
+	void ResetHiZ() { _HiZBuilt = false; }
+	// of the last Draw(), nullptr if it kept none
+	const HiZPyramid* GetHiZPyramid(UINT view) const
+	{
+		assert(view < Settings::FrustumsCount);
+		return _HiZBuilt ? &_HiZPyramids[view] : nullptr;
+	}
+	// the pyramid of the view was drawn with
+	const DirectX::XMFLOAT4X4& GetHiZViewProjection(UINT view) const
+	{
+		assert(view < Settings::FrustumsCount);
+		return _HiZViewProjections[view];
+	}
+
+	// picks the big triangle threshold and the tile size by the time
+	// of every Draw(), logs the chosen values
+	void SetAutoTuning(bool enabled);
+	bool IsAutoTuning() const { return _autoTuning; }
+	UINT GetBigTriangleThreshold() const { return _bigTriangleThreshold; }
+	UINT GetTileSize() const { return _tileSize; }
+	// bounding box pixels per second of the small and big triangle paths
+	// in the last Draw()
+	float GetSmallTrianglesMPixelsPerSecond() const
+	{
+		return _pathMPixelsPerSecond[SmallTriangles];
+	}
+	float GetBigTrianglesMPixelsPerSecond() const
+	{
+		return _pathMPixelsPerSecond[BigTriangles];
+	}
+
+private:
+
+	// benchmarks and checks drive the passes below directly
+	friend class CPURasterizerDiagnostics;
+
+	// the near plane and 4 guard band planes
+	static const UINT ClipPlanesCount = 5;
+	static const UINT CacheLineSize = 64;
+	// meshlets have up to 128, bigger meshes are not cached
+	static const UINT MaxCachedVertices = 256;
+	// view depth of an instance is quantized to 16 bits for sorting
+	static const UINT FrontToBackKeyMax = 0xFFFF;
+	// of a triangle set up without its meshlet's bounds
+	static const UINT NoMeshletBounds = ~0u;
+
+	// everything the tiles need to know about a visible triangle
+	struct TriangleSetup
+	{
+		// snapped to the sub-pixel grid
+		DirectX::XMFLOAT2 p0SS;
+		DirectX::XMFLOAT2 p1SS;
+		DirectX::XMFLOAT2 p2SS;
+		// in 1 / SubpixelScale of a pixel
+		DirectX::XMINT2 p0Fixed;
+		DirectX::XMINT2 p1Fixed;
+		DirectX::XMINT2 p2Fixed;
+		float z0NDC;
+		float z1NDC;
+		float z2NDC;
+		float invW0;
+		float invW1;
+		float invW2;
+		float invArea;
+		// snapped to pixel centers and clamped to screen bounds
+		DirectX::XMFLOAT2 minP;
+		DirectX::XMFLOAT2 maxP;
+
+		// for the opaque pass only
+		// weights of the vertices within the original triangle,
+		// differ from the identity if it was clipped
+		DirectX::XMFLOAT3 barycentrics0;
+		DirectX::XMFLOAT3 barycentrics1;
+		DirectX::XMFLOAT3 barycentrics2;
+		DirectX::XMFLOAT3 p0WS;
+		DirectX::XMFLOAT3 p1WS;
+		DirectX::XMFLOAT3 p2WS;
+		UINT i0;
+		UINT i1;
+		UINT i2;
+		INT baseVertexLocation;
+		UINT instanceIndex;
+		// into _meshletBounds of the same worker
+		UINT meshletBounds;
+	};
+
+	// unpacked once per triangle and tile
+	struct TriangleAttributes
+	{
+		DirectX::XMFLOAT3 normals[3];
+		DirectX::XMFLOAT3 colors[3];
+	};
+
+	enum InterpolatedAttributes
+	{
+		NormalAttribute,
+		ColorAttribute,
+		PositionWSAttribute,
+		InterpolatedAttributesCount
+	};
+
+	// attribute / w and 1 / w are linear in screen space,
+	// so they are planes over the pixels of a RasterTriangle,
+	// a + x * dx + y * dy at offsets from its origin
+	struct AttributePlanes
+	{
+		DirectX::XMFLOAT3 attributes[InterpolatedAttributesCount];
+		DirectX::XMFLOAT3 attributesDx[InterpolatedAttributesCount];
+		DirectX::XMFLOAT3 attributesDy[InterpolatedAttributesCount];
+		float invW;
+		float invWDx;
+		float invWDy;
+	};
+
+	struct ViewParams
+	{
+		DirectX::XMFLOAT4X4 VP;
+		// pCS is inside if dot(plane, pCS) >= 0
+		DirectX::XMFLOAT4 clipPlanes[ClipPlanesCount];
+		UINT width;
+		UINT height;
+		UINT tilesX;
+		UINT tilesY;
+		// of the view's tiles in _bins
+		UINT firstBin;
+		// its depth target is tiled, only the depth pass draws it
+		bool tiled;
+		// of the previous Draw() to cull against, set by Draw() only
+		const HiZPyramid* HiZ;
+		// VP is the one HiZ was drawn with, else the vertices are taken
+		// from the clip space of VP to the one of HiZ by HiZReprojection
+		bool HiZSameVP;
+		DirectX::XMFLOAT4X4 HiZReprojection;
+	};
+
+	enum StatsIndices
+	{
+		PipelineTriangles,
+		RenderedTriangles,
+		FetchedVertices,
+		TransformedVertices,
+		SkippedTileTriangles,
+		SkippedTileMeshlets,
+		CompactedTriangles,
+		FilteredTriangles,
+		ShadedPixels,
+		MicroTriangleTiles,
+		// one per TriangleSizes
+		TriangleSizeCounts,
+		// one per RejectionReasons
+		RejectedTriangles = TriangleSizeCounts + TriangleSizesCount,
+		StatsCount = RejectedTriangles + RejectionReasonsCount
+	};
+
+	enum Paths
+	{
+		SmallTriangles,
+		BigTriangles,
+		PathsCount
+	};
+
+	// of the tiles rasterized by a worker
+	struct PathStats
+	{
+		double seconds = 0.0;
+		UINT64 pixels = 0;
+	};
+
+	// counted by a single worker and reduced after the passes,
+	// padded to a cache line, so workers never write to a shared one
+	struct alignas(CacheLineSize) WorkerStats
+	{
+		UINT counts[StatsCount];
+		PathStats paths[PathsCount];
+	};
+
+	// unique vertices of a mesh of the scene,
+	// the vertex cache keeps them in this order
+	struct Meshlet
+	{
+		UINT firstVertex;
+		// 0 if they don't fit the vertex cache
+		UINT verticesCount;
+	};
+
+	// per worker, of the meshlet being set up
+	struct VertexCache
+	{
+		DirectX::XMFLOAT3 positionsWS[MaxCachedVertices];
+		DirectX::XMFLOAT4
+			positionsCS[Settings::FrustumsCount][MaxCachedVertices];
+	};
+
+	// of a meshlet's instance in a view, so the in-frame Hi-Z
+	// can skip all of its triangles of a tile at once
+	struct MeshletBounds
+	{
+		// inclusive pixels
+		UINT minX;
+		UINT minY;
+		UINT maxX;
+		UINT maxY;
+		float maxZ;
+	};
+
+	// a triangle of a camera tile drawn by the depth pass
+	struct CompactTriangle
+	{
+		RasterTriangle raster;
+		const TriangleSetup* setup;
+		// pixels of the tile it covers
+		UINT originX;
+		UINT originY;
+		UINT width;
+		UINT height;
+	};
+
+	// an instance of a draw list in front-to-back order
+	struct SortedInstance
+	{
+		// quantized view depth, 0 is the nearest
+		UINT key;
+		UINT commandIndex;
+		UINT instanceIndex;
+	};
+
+	enum TunedParameters
+	{
+		BigTriangleThresholdParameter,
+		TileSizeParameter
+	};
+
+	void _setTileSize(UINT tileSize);
+	void _tune();
+	// orthographic views, such as the cascades, have w = 1
+	// and are set up for the depth pass only,
+	// several views need viewsMasks in the draw list
+	template <bool Orthographic>
+	void _binTriangles(
+		const ViewParams* views,
+		UINT viewsCount,
+		const DrawList& drawList);
+	template <bool Orthographic>
+	void _setupTriangle(
+		const ViewParams* views,
+		UINT viewsMask,
+		const Instance& instance,
+		UINT instanceIndex,
+		UINT startIndexLocation,
+		INT baseVertexLocation,
+		UINT worker);
+	template <bool Orthographic>
+	void _setupMeshlet(
+		const ViewParams* views,
+		UINT viewsMask,
+		const Instance& instance,
+		UINT instanceIndex,
+		UINT startIndexLocation,
+		UINT indexCount,
+		UINT worker);
+	template <bool Orthographic>
+	void _projectTriangle(
+		const ViewParams& view,
+		const TriangleSetup& triangle,
+		const DirectX::XMFLOAT4* positionsCS,
+		UINT worker);
+	void _buildMeshlets();
+	// index into _meshletBounds of the worker or NoMeshletBounds
+	UINT _boundMeshlet(
+		const ViewParams& view,
+		const DirectX::XMFLOAT4* positionsCS,
+		UINT verticesCount,
+		UINT worker);
+	void _sortInstances(const ViewParams& view, const DrawList& drawList);
+	void _binSetup(const ViewParams& view, const TriangleSetup& t, UINT worker);
+	// positionsCS are of the whole triangle, t of its piece
+	bool _isHiZOccluded(
+		const ViewParams& view,
+		const TriangleSetup& t,
+		const DirectX::XMFLOAT4* positionsCS) const;
+	void _getTileRect(const ViewParams& view, UINT tile, UINT rect[4]) const;
+	void _resetHiZ(
+		const ViewParams& view,
+		const UINT tileRect[4],
+		float blockDepth);
+	float _getBlockDepth(
+		const ViewParams& view,
+		const float* depth,
+		UINT blockX,
+		UINT blockY) const;
+	bool _isOccluded(
+		const ViewParams& view,
+		const float* depth,
+		UINT minX,
+		UINT minY,
+		UINT maxX,
+		UINT maxY,
+		float maxZ);
+	void _updateHiZ(
+		const ViewParams& view,
+		const RasterTriangle& raster,
+		UINT originX,
+		UINT originY,
+		UINT width,
+		UINT height);
+	// kernel replaces the ones of both paths if given,
+	// compactedTiles gets the drawn triangles if given, [path][tile]
+	void _rasterizeDepth(
+		const ViewParams& view,
+		float* depth,
+		RasterizerKernels::DepthKernel kernel = nullptr,
+		std::vector<std::vector<CompactTriangle>>* compactedTiles = nullptr);
+	void _filterCompactedTriangles();
+	void _rasterizeOpaque(const DrawList& drawList);
+	void _rasterizeVisibilityBuffer(const ViewParams& view);
+	void _resolveVisibilityBuffer(const DrawList& drawList);
+	const TriangleSetup& _getSetup(UINT id) const;
+	void _fetchAttributes(
+		const TriangleSetup& t,
+		TriangleAttributes& attributes) const;
+	DirectX::XMFLOAT4 _shadePixel(
+		const TriangleSetup& t,
+		const TriangleAttributes& attributes,
+		const Instance& instance,
+		float weight0,
+		float weight1,
+		float weight2) const;
+	void _setupAttributePlanes(
+		const TriangleSetup& t,
+		const TriangleAttributes& attributes,
+		const RasterTriangle& raster,
+		AttributePlanes& planes) const;
+	DirectX::XMFLOAT4 _shadePixel(
+		const AttributePlanes& planes,
+		const Instance& instance,
+		float x,
+		float y) const;
+	DirectX::XMFLOAT4 _shade(
+		DirectX::FXMVECTOR normal,
+		DirectX::FXMVECTOR color,
+		DirectX::FXMVECTOR positionWS,
+		float viewDepth,
+		const Instance& instance) const;
+	float _getShadow(float viewDepth, DirectX::FXMVECTOR positionWS) const;
+
+	ThreadPool _threadPool;
+	const RasterizerKernels::Kernels* _kernels = nullptr;
+
+	UINT _width = 0;
+	UINT _height = 0;
+	ViewParams _views[Settings::FrustumsCount] = {};
+
+	std::vector<DirectX::XMFLOAT4> _renderTarget;
+	std::vector<float> _depthBuffer;
+	// see RasterizerKernels::PackVisibility
+	std::vector<UINT64> _visibilityBuffer;
+	bool _visibilityBufferEnabled = false;
+
+	// indexed with meshID
+	std::vector<Meshlet> _meshlets;
+	// with baseVertexLocation
+	std::vector<UINT> _meshletVertices;
+	// per index of the scene, of the vertex within its meshlet
+	std::vector<UINT8> _meshletIndices;
+	const Scene* _meshletsScene = nullptr;
+	std::vector<VertexCache> _vertexCaches;
+	bool _vertexCacheEnabled = false;
+	std::vector<SortedInstance> _sortedInstances;
+	std::vector<SortedInstance> _sortedInstancesScratch;
+	bool _frontToBackEnabled = false;
+	// per worker, as _setups
+	std::vector<std::vector<MeshletBounds>> _meshletBounds;
+	// farthest depth of each BlockSize^2 pixels of the view being drawn,
+	// < 0 if it has to be found again
+	std::vector<float> _inFrameHiZ;
+	bool _inFrameHiZEnabled = false;
+	// [path][camera tile]
+	std::vector<std::vector<CompactTriangle>> _compactedTriangles[PathsCount];
+	bool _triangleCompactionEnabled = false;
+	bool _attributePlanesEnabled = false;
+	bool _microTrianglesEnabled = false;
+	std::vector<float> _shadowMaps[Settings::CascadesCount];
+	HiZPyramid _HiZPyramids[Settings::FrustumsCount];
+	DirectX::XMFLOAT4X4 _HiZViewProjections[Settings::FrustumsCount];
+	bool _HiZBuilt = false;
+	bool _HiZCullingEnabled = false;
+	HiZPyramid::Tests _HiZTest = HiZPyramid::FootprintTaps;
+
+	UINT _bigTriangleThreshold = DefaultBigTriangleThreshold;
+	UINT _tileSize = DefaultTileSize;
+
+	// per worker, so binning needs no synchronization
+	std::vector<std::vector<TriangleSetup>> _setups;
+	// visibility buffer id of the first setup of every worker,
+	// the last one is the total count + 1
+	std::vector<UINT> _setupOffsets;
+	// [path][worker][tile] - indices into _setups[worker]
+	std::vector<std::vector<std::vector<UINT>>> _bins[PathsCount];
+	std::vector<WorkerStats> _stats;
+	// per worker, visible pixels of a triangle within a tile
+	std::vector<std::vector<UINT>> _visiblePixels;
+
+	// mirrors SWRSceneCB
+	DirectX::XMFLOAT3 _sunDirection;
+	DirectX::XMFLOAT4X4 _cascadeVP[Settings::CascadesCount];
+	float _cascadeBias[Settings::CascadesCount];
+	float _cascadeSplits[Settings::CascadesCount];
+	bool _showCascades = false;
+	bool _showMeshlets = false;
+
+	UINT _statsResult[StatsCount] = {};
+	float _rasterizationTimeMS = 0.0f;
+	float _filterTimeMS = 0.0f;
+	float _opaqueTimeMS = 0.0f;
+	size_t _compactedTrianglesBytes = 0;
+	float _pathMPixelsPerSecond[PathsCount] = {};
+
+	AutoTuner _tuner;
+	bool _autoTuning = false;
+};
\ No newline at end of file
@@ -0,0 +1,1730 @@
+#include "CPURasterizerDiagnostics.h"
+#include "RasterizerSetup.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+using namespace RasterizerSetup;
+
+namespace
+{
+
+// of CountingDepth, pixels whose depth was tested and of them brought closer
+std::atomic<UINT64> DepthTests = 0;
+std::atomic<UINT64> DepthWrites = 0;
+
+// DepthSmall that counts, for the front-to-back benchmark
+void CountingDepth(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch)
+{
+	UINT64 tests = 0;
+	UINT64 writes = 0;
+	for (UINT y = 0; y < height; y++)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			if (RasterizerKernels::IsCovered(t, x, y))
+			{
+				float& dst = depth[y * pitch + x];
+				float z = RasterizerKernels::PlaneDepth(
+					t,
+					static_cast<float>(x),
+					static_cast<float>(y));
+				tests++;
+				if (z > dst)
+				{
+					dst = z;
+					writes++;
+				}
+			}
+		}
+	}
+
+	DepthTests += tests;
+	DepthWrites += writes;
+}
+
+}
+
+CPURasterizerDiagnostics::CPURasterizerDiagnostics(
+	CPURasterizer& rasterizer) :
+	_rasterizer(rasterizer)
+{
+}
+
+bool CPURasterizerDiagnostics::HasRequests() const
+{
+	return std::find(
+		std::begin(_requested),
+		std::end(_requested),
+		true) != std::end(_requested);
+}
+
+void CPURasterizerDiagnostics::RunRequests(
+	const DrawList* drawLists,
+	UINT drawListsCount,
+	const DrawList* cascadesDrawList)
+{
+	if (_requested[ShadowsBenchmark])
+	{
+		BenchmarkShadows(drawLists, drawListsCount, cascadesDrawList);
+	}
+	if (_requested[FrontToBackBenchmark])
+	{
+		BenchmarkFrontToBack(drawLists[0]);
+	}
+	if (_requested[TriangleCompactionBenchmark])
+	{
+		BenchmarkTriangleCompaction(drawLists[0]);
+	}
+	if (_requested[ShadingBenchmark])
+	{
+		BenchmarkShading(drawLists[0]);
+	}
+	if (_requested[MicroTrianglesBenchmark])
+	{
+		BenchmarkMicroTriangles(drawLists[0]);
+	}
+	if (_requested[LayoutsBenchmark])
+	{
+		BenchmarkLayouts(drawLists, drawListsCount);
+	}
+	if (_requested[HiZBenchmark])
+	{
+		BenchmarkHiZ();
+	}
+
+	std::fill(std::begin(_requested), std::end(_requested), false);
+}
+
+void CPURasterizerDiagnostics::BenchmarkKernels()
+{
+	const UINT PixelsPerRun = 1 << 24;
+
+	const UINT TileSize = CPURasterizer::DefaultTileSize;
+	std::vector<float> depth(TileSize * TileSize);
+	std::vector<UINT> visiblePixels(TileSize * TileSize);
+	XMFLOAT2 tileMinP = { 0.5f, 0.5f };
+	XMFLOAT2 tileMaxP =
+	{
+		static_cast<float>(CPURasterizer::DefaultTileSize) - 0.5f,
+		static_cast<float>(CPURasterizer::DefaultTileSize) - 0.5f
+	};
+
+	Utils::PrintToOutput(
+		"CPU rasterizer kernels, Mpixels/s of depth / visibility:\n");
+	for (UINT pixels = 1; pixels <= 4096; pixels *= 2)
+	{
+		// right isosceles triangle of the given area
+		float leg = std::sqrt(2.0f * pixels);
+		TriangleSetup t = {};
+		t.p0SS = { 0.0f, 0.0f };
+		t.p1SS = { leg, 0.0f };
+		t.p2SS = { 0.0f, leg };
+		t.z0NDC = 0.1f;
+		t.z1NDC = 0.2f;
+		t.z2NDC = 0.3f;
+		SetupScreenTriangle(
+			t,
+			static_cast<float>(CPURasterizer::DefaultTileSize),
+			static_cast<float>(CPURasterizer::DefaultTileSize));
+
+		RasterTriangle raster;
+		UINT originX, originY, width, height;
+		SetupTileRaster(
+			t,
+			tileMinP,
+			tileMaxP,
+			raster,
+			originX, originY,
+			width, height);
+
+		UINT runsCount = std::max(PixelsPerRun / pixels, 1u);
+		std::string line = std::to_string(pixels) + " px:";
+		for (UINT type = 0; type < RasterizerKernels::TypesCount; type++)
+		{
+			auto kernelsType = static_cast<RasterizerKernels::Type>(type);
+			if (!RasterizerKernels::IsSupported(kernelsType))
+			{
+				continue;
+			}
+			const auto& kernels = RasterizerKernels::Get(kernelsType);
+
+			std::fill(depth.begin(), depth.end(), 0.0f);
+			auto start = std::chrono::high_resolution_clock::now();
+			for (UINT run = 0; run < runsCount; run++)
+			{
+				kernels.depth(
+					raster,
+					width,
+					height,
+					depth.data(),
+					CPURasterizer::DefaultTileSize);
+			}
+			auto finish = std::chrono::high_resolution_clock::now();
+			float depthSeconds =
+				std::chrono::duration<float>(finish - start).count();
+
+			UINT visibleCount = 0;
+			start = std::chrono::high_resolution_clock::now();
+			for (UINT run = 0; run < runsCount; run++)
+			{
+				visibleCount += kernels.visibility(
+					raster,
+					width,
+					height,
+					depth.data(),
+					CPURasterizer::DefaultTileSize,
+					visiblePixels.data());
+			}
+			finish = std::chrono::high_resolution_clock::now();
+			float visibilitySeconds =
+				std::chrono::duration<float>(finish - start).count();
+
+			float megaPixels = 1e-6f * pixels * runsCount;
+			char result[128];
+			sprintf_s(
+				result,
+				" %s %.1f / %.1f (%u visible)",
+				kernels.name,
+				megaPixels / depthSeconds,
+				megaPixels / visibilitySeconds,
+				visibleCount / runsCount);
+			line += result;
+		}
+		Utils::PrintToOutput("%s\n", line.c_str());
+	}
+}
+
+void CPURasterizerDiagnostics::CheckWatertightness()
+{
+	// 2 x 2 tiles, so triangles are split by tiles as well
+	const UINT Size = 2 * CPURasterizer::DefaultTileSize;
+	const UINT CellsCount = 16;
+	const float CellSize = static_cast<float>(Size / CellsCount);
+	const UINT GridsCount = 64;
+
+	// reversed Z with all depths 0 makes visibility a coverage test
+	const UINT TileSize = CPURasterizer::DefaultTileSize;
+	std::vector<float> depth(TileSize * TileSize, 0.0f);
+	std::vector<UINT> visiblePixels(TileSize * TileSize);
+	std::vector<UINT> coverage(Size * Size);
+	std::vector<XMFLOAT2> vertices((CellsCount + 1) * (CellsCount + 1));
+
+	for (UINT type = 0; type < RasterizerKernels::TypesCount; type++)
+	{
+		auto kernelsType = static_cast<RasterizerKernels::Type>(type);
+		if (!RasterizerKernels::IsSupported(kernelsType))
+		{
+			continue;
+		}
+		const auto& kernels = RasterizerKernels::Get(kernelsType);
+
+		UINT failedPixels = 0;
+		for (UINT grid = 0; grid < GridsCount; grid++)
+		{
+			// small enough jitter to keep all triangles front facing
+			std::mt19937 random(grid);
+			std::uniform_real_distribution<float> jitter(
+				-0.125f * CellSize,
+				0.125f * CellSize);
+
+			for (UINT y = 0; y <= CellsCount; y++)
+			{
+				for (UINT x = 0; x <= CellsCount; x++)
+				{
+					XMFLOAT2& p = vertices[y * (CellsCount + 1) + x];
+					p = { x * CellSize, y * CellSize };
+					if (x == 0 || y == 0 || x == CellsCount || y == CellsCount)
+					{
+						continue;
+					}
+
+					// straight horizontal and vertical edges
+					// through pixel centers in the middle
+					p.x += (x == CellsCount / 2) ? 0.5f : jitter(random);
+					p.y += (y == CellsCount / 2) ? 0.5f : jitter(random);
+					// vertices right on pixel centers
+					if ((x + y) % 3 == 0)
+					{
+						p.x = std::floor(p.x) + 0.5f;
+						p.y = std::floor(p.y) + 0.5f;
+					}
+				}
+			}
+
+			std::fill(coverage.begin(), coverage.end(), 0);
+			for (UINT cell = 0; cell < CellsCount * CellsCount; cell++)
+			{
+				UINT x = cell % CellsCount;
+				UINT y = cell / CellsCount;
+				const XMFLOAT2& p00 = vertices[y * (CellsCount + 1) + x];
+				const XMFLOAT2& p10 = vertices[y * (CellsCount + 1) + x + 1];
+				const XMFLOAT2& p01 = vertices[(y + 1) * (CellsCount + 1) + x];
+				const XMFLOAT2& p11 =
+					vertices[(y + 1) * (CellsCount + 1) + x + 1];
+
+				// both diagonals
+				XMFLOAT2 triangles[2][3] =
+				{
+					{ p00, p10, (cell % 2) ? p11 : p01 },
+					{ (cell % 2) ? p00 : p10, p11, p01 }
+				};
+				for (const auto& triangle : triangles)
+				{
+					TriangleSetup t = {};
+					t.p0SS = triangle[0];
+					t.p1SS = triangle[1];
+					t.p2SS = triangle[2];
+					if (!SetupScreenTriangle(
+						t,
+						static_cast<float>(Size),
+						static_cast<float>(Size)))
+					{
+						continue;
+					}
+
+					for (UINT tile = 0; tile < 4; tile++)
+					{
+						XMFLOAT2 tileMinP, tileMaxP;
+						GetTileBounds(
+							tile % 2,
+							tile / 2,
+							CPURasterizer::DefaultTileSize,
+							tileMinP,
+							tileMaxP);
+
+						RasterTriangle raster;
+						UINT originX, originY, width, height;
+						if (!SetupTileRaster(
+							t,
+							tileMinP,
+							tileMaxP,
+							raster,
+							originX, originY,
+							width, height))
+						{
+							continue;
+						}
+
+						UINT visibleCount = kernels.visibility(
+							raster,
+							width,
+							height,
+							depth.data(),
+							CPURasterizer::DefaultTileSize,
+							visiblePixels.data());
+						for (UINT pixel = 0; pixel < visibleCount; pixel++)
+						{
+							UINT px = originX + (visiblePixels[pixel] & 0xFFFF);
+							UINT py = originY + (visiblePixels[pixel] >> 16);
+							coverage[py * Size + px]++;
+						}
+					}
+				}
+			}
+
+			failedPixels += static_cast<UINT>(std::count_if(
+				coverage.begin(),
+				coverage.end(),
+				[](UINT count) { return count != 1; }));
+		}
+
+		Utils::PrintToOutput(
+			"CPU rasterizer %s watertightness: "
+			"%u of %u pixels are not covered exactly once\n",
+			kernels.name,
+			failedPixels,
+			Size * Size * GridsCount);
+	}
+}
+
+void CPURasterizerDiagnostics::CheckClipping()
+{
+	const UINT Size = 2 * CPURasterizer::DefaultTileSize;
+	const UINT ViewsCount = 64;
+	const float NearZ = 0.1f;
+
+	// a box of [-1, 1], corner index is x | y << 1 | z << 2
+	XMFLOAT3 corners[8];
+	for (UINT corner = 0; corner < 8; corner++)
+	{
+		corners[corner] =
+		{
+			(corner & 1) ? 1.0f : -1.0f,
+			(corner & 2) ? 1.0f : -1.0f,
+			(corner & 4) ? 1.0f : -1.0f
+		};
+	}
+
+	// 2 triangles per face, facing the inside of the box
+	std::vector<std::array<XMFLOAT3, 3>> triangles;
+	for (UINT axis = 0; axis < 3; axis++)
+	{
+		UINT uBit = 1 << ((axis + 1) % 3);
+		UINT vBit = 1 << ((axis + 2) % 3);
+		for (UINT side = 0; side < 2; side++)
+		{
+			UINT base = side ? (1 << axis) : 0;
+			UINT quad[4] =
+			{
+				base,
+				base | uBit,
+				base | uBit | vBit,
+				base | vBit
+			};
+			UINT quadTriangles[2][3] =
+			{
+				{ quad[0], quad[1], quad[2] },
+				{ quad[0], quad[2], quad[3] }
+			};
+			for (const auto& indices : quadTriangles)
+			{
+				std::array<XMFLOAT3, 3> triangle =
+				{
+					corners[indices[0]],
+					corners[indices[1]],
+					corners[indices[2]]
+				};
+
+				// clockwise as seen from the center
+				XMVECTOR p0 = XMLoadFloat3(&triangle[0]);
+				XMVECTOR normal = XMVector3Cross(
+					XMLoadFloat3(&triangle[1]) - p0,
+					XMLoadFloat3(&triangle[2]) - p0);
+				if (XMVectorGetX(XMVector3Dot(normal, p0)) > 0.0f)
+				{
+					std::swap(triangle[1], triangle[2]);
+				}
+				triangles.push_back(triangle);
+			}
+		}
+	}
+
+	ViewParams view = {};
+	view.width = Size;
+	view.height = Size;
+	SetClipPlanes(
+		XMFLOAT4(0.0f, 0.0f, -1.0f, 1.0f),
+		view.width,
+		view.height,
+		view.clipPlanes);
+
+	// reversed Z with all depths 0 makes visibility a coverage test
+	const UINT TileSize = CPURasterizer::DefaultTileSize;
+	std::vector<float> depth(TileSize * TileSize, 0.0f);
+	std::vector<UINT> visiblePixels(TileSize * TileSize);
+	std::vector<UINT> coverage(Size * Size);
+
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+	UINT failedPixels = 0;
+	for (UINT viewIndex = 0; viewIndex < ViewsCount; viewIndex++)
+	{
+		// within the box, so its walls cross the near plane
+		XMVECTOR position = XMVectorSet(
+			0.5f * uniform(random),
+			0.5f * uniform(random),
+			0.5f * uniform(random),
+			1.0f);
+		XMVECTOR direction = XMVector3Normalize(XMVectorSet(
+			uniform(random),
+			uniform(random),
+			uniform(random),
+			0.0f));
+		XMVECTOR up = (std::abs(XMVectorGetY(direction)) < 0.9f)
+			? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)
+			: XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+
+		// same as Camera::SetProjection with reversed Z
+		XMMATRIX reverseZ = XMMatrixSet(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, -1.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 1.0f);
+		XMMATRIX VP =
+			XMMatrixLookToLH(position, direction, up) *
+			XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, NearZ, 10.0f) *
+			reverseZ;
+
+		std::fill(coverage.begin(), coverage.end(), 0);
+		for (const auto& triangle : triangles)
+		{
+			ClipVertex polygon[MaxClippedVertices];
+			for (UINT vertex = 0; vertex < 3; vertex++)
+			{
+				XMStoreFloat4(
+					&polygon[vertex].positionCS,
+					XMVector4Transform(
+						XMVectorSetW(XMLoadFloat3(&triangle[vertex]), 1.0f),
+						VP));
+				polygon[vertex].barycentrics = {};
+			}
+			UINT verticesCount =
+				ClipTriangle(
+					view.clipPlanes,
+					CPURasterizer::ClipPlanesCount,
+					polygon);
+
+			for (UINT vertex = 2; vertex < verticesCount; vertex++)
+			{
+				TriangleSetup t;
+				if (!ProjectTriangle(
+					polygon[0],
+					polygon[vertex - 1],
+					polygon[vertex],
+					static_cast<float>(Size),
+					static_cast<float>(Size),
+					t))
+				{
+					continue;
+				}
+				t.z0NDC = 0.0f;
+				t.z1NDC = 0.0f;
+				t.z2NDC = 0.0f;
+
+				for (UINT tile = 0; tile < 4; tile++)
+				{
+					XMFLOAT2 tileMinP, tileMaxP;
+					GetTileBounds(
+						tile % 2,
+						tile / 2,
+						CPURasterizer::DefaultTileSize,
+						tileMinP,
+						tileMaxP);
+
+					RasterTriangle raster;
+					UINT originX, originY, width, height;
+					if (!SetupTileRaster(
+						t,
+						tileMinP,
+						tileMaxP,
+						raster,
+						originX, originY,
+						width, height))
+					{
+						continue;
+					}
+
+					UINT visibleCount = _rasterizer._kernels->visibility(
+						raster,
+						width,
+						height,
+						depth.data(),
+						CPURasterizer::DefaultTileSize,
+						visiblePixels.data());
+					for (UINT pixel = 0; pixel < visibleCount; pixel++)
+					{
+						UINT px = originX + (visiblePixels[pixel] & 0xFFFF);
+						UINT py = originY + (visiblePixels[pixel] >> 16);
+						coverage[py * Size + px]++;
+					}
+				}
+			}
+		}
+
+		failedPixels += static_cast<UINT>(std::count_if(
+			coverage.begin(),
+			coverage.end(),
+			[](UINT count) { return count != 1; }));
+	}
+
+	Utils::PrintToOutput(
+		"CPU rasterizer clipping: "
+		"%u of %u pixels are not covered exactly once\n",
+		failedPixels,
+		Size * Size * ViewsCount);
+}
+
+void CPURasterizerDiagnostics::BenchmarkBigTriangles()
+{
+	using namespace RasterizerKernels;
+
+	const UINT RunsCount = 8;
+	const ViewParams& view = _rasterizer._views[0];
+
+	// camera bins are the last ones
+	std::vector<const TriangleSetup*> bigTriangles;
+	for (const auto& setups : _rasterizer._setups)
+	{
+		for (const TriangleSetup& t : setups)
+		{
+			if (static_cast<UINT>(t.minP.x) / _rasterizer._tileSize
+				!= static_cast<UINT>(t.maxP.x) / _rasterizer._tileSize
+				|| static_cast<UINT>(t.minP.y) / _rasterizer._tileSize
+				!= static_cast<UINT>(t.maxP.y) / _rasterizer._tileSize)
+			{
+				bigTriangles.push_back(&t);
+			}
+		}
+	}
+
+	// calls tileFunc for every tile of the triangle's bounding box
+	auto forEachTile = [&](const TriangleSetup& t, auto&& tileFunc)
+	{
+		UINT maxTileX = std::min(
+			static_cast<UINT>(t.maxP.x) / _rasterizer._tileSize,
+			view.tilesX - 1);
+		UINT maxTileY = std::min(
+			static_cast<UINT>(t.maxP.y) / _rasterizer._tileSize,
+			view.tilesY - 1);
+		for (UINT tileY = static_cast<UINT>(t.minP.y) / _rasterizer._tileSize;
+			tileY <= maxTileY;
+			tileY++)
+		{
+			for (UINT tileX =
+					static_cast<UINT>(t.minP.x) / _rasterizer._tileSize;
+				tileX <= maxTileX;
+				tileX++)
+			{
+				tileFunc(tileX, tileY);
+			}
+		}
+	};
+
+	UINT tiles[3] = {};
+	UINT blocks[3] = {};
+	for (const TriangleSetup* t : bigTriangles)
+	{
+		forEachTile(*t, [&](UINT tileX, UINT tileY)
+		{
+			BlockCoverage tileCoverage =
+				ClassifyTile(*t, tileX, tileY, _rasterizer._tileSize);
+			tiles[tileCoverage]++;
+			if (tileCoverage == Outside)
+			{
+				return;
+			}
+
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(
+				tileX, tileY, _rasterizer._tileSize, tileMinP, tileMaxP);
+			RasterTriangle raster;
+			UINT originX, originY, width, height;
+			SetupTileRaster(
+				*t,
+				tileMinP,
+				tileMaxP,
+				raster,
+				originX, originY,
+				width, height);
+			for (UINT by = 0; by < height; by += BlockSize)
+			{
+				for (UINT bx = 0; bx < width; bx += BlockSize)
+				{
+					blocks[ClassifyBlock(
+						raster,
+						bx, by,
+						std::min(bx + BlockSize, width) - 1,
+						std::min(by + BlockSize, height) - 1)]++;
+				}
+			}
+		});
+	}
+
+	Utils::PrintToOutput(
+		"CPU rasterizer big triangles: %u, "
+		"tiles outside / partial / inside: %u / %u / %u, "
+		"8x8 blocks of the rest: %u / %u / %u\n",
+		static_cast<UINT>(bigTriangles.size()),
+		tiles[Outside], tiles[Partial], tiles[Inside],
+		blocks[Outside], blocks[Partial], blocks[Inside]);
+
+	// single threaded, milliseconds per run
+	std::vector<float> depth(view.width * view.height);
+	auto measure = [&](auto&& rasterize)
+	{
+		float seconds = 0.0f;
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			std::fill(depth.begin(), depth.end(), 0.0f);
+			auto start = std::chrono::high_resolution_clock::now();
+			for (const TriangleSetup* t : bigTriangles)
+			{
+				rasterize(*t);
+			}
+			auto finish = std::chrono::high_resolution_clock::now();
+			seconds += std::chrono::duration<float>(finish - start).count();
+		}
+
+		return 1000.0f * seconds / RunsCount;
+	};
+
+	// every pixel of every tile
+	float perPixelMS = measure([&](const TriangleSetup& t)
+	{
+		forEachTile(t, [&](UINT tileX, UINT tileY)
+		{
+			XMFLOAT2 tileMinP, tileMaxP;
+			GetTileBounds(
+				tileX, tileY, _rasterizer._tileSize, tileMinP, tileMaxP);
+			RasterTriangle raster;
+			UINT originX, originY, width, height;
+			if (!SetupTileRaster(
+				t,
+				tileMinP,
+				tileMaxP,
+				raster,
+				originX, originY,
+				width, height))
+			{
+				return;
+			}
+
+			for (UINT y = 0; y < height; y++)
+			{
+				for (UINT x = 0; x < width; x++)
+				{
+					if (IsCovered(raster, x, y))
+					{
+						float& dst =
+							depth[(originY + y) * view.width + originX + x];
+						dst = std::max(
+							dst,
+							PlaneDepth(
+								raster,
+								static_cast<float>(x),
+								static_cast<float>(y)));
+					}
+				}
+			}
+		});
+	});
+	std::vector<float> perPixelDepth = depth;
+	Utils::PrintToOutput("  per pixel: %.2f ms\n", perPixelMS);
+
+	for (UINT type = 0; type < TypesCount; type++)
+	{
+		if (!IsSupported(static_cast<Type>(type)))
+		{
+			continue;
+		}
+		const Kernels& kernels = Get(static_cast<Type>(type));
+
+		// as _rasterizer._binTriangles and _rasterizer._rasterizeDepth do it
+		float coarseMS = measure([&](const TriangleSetup& t)
+		{
+			forEachTile(t, [&](UINT tileX, UINT tileY)
+			{
+				if (ClassifyTile(t, tileX, tileY, _rasterizer._tileSize)
+					== Outside)
+				{
+					return;
+				}
+
+				XMFLOAT2 tileMinP, tileMaxP;
+				GetTileBounds(
+					tileX, tileY, _rasterizer._tileSize, tileMinP, tileMaxP);
+				RasterTriangle raster;
+				UINT originX, originY, width, height;
+				SetupTileRaster(
+					t,
+					tileMinP,
+					tileMaxP,
+					raster,
+					originX, originY,
+					width, height);
+				kernels.depth(
+					raster,
+					width,
+					height,
+					depth.data() + originY * view.width + originX,
+					view.width);
+			});
+		});
+
+		Utils::PrintToOutput(
+			"  %s coarse: %.2f ms, %s\n",
+			kernels.name,
+			coarseMS,
+			(depth == perPixelDepth) ? "same depth" : "DEPTH MISMATCH");
+	}
+
+	// as BigTriangleDepthCS did, when its queue had an entry per tile,
+	// the triangle is set up again from its vertices for every tile,
+	// here it's done once per triangle, as the queue does it now,
+	// clipped triangles keep their setup, since the GPU path drops them
+	XMMATRIX VP = XMLoadFloat4x4(&view.VP);
+	UINT clippedTriangles = 0;
+	for (const TriangleSetup* t : bigTriangles)
+	{
+		if (t->barycentrics0.x != 1.0f
+			|| t->barycentrics1.y != 1.0f
+			|| t->barycentrics2.z != 1.0f)
+		{
+			clippedTriangles++;
+		}
+	}
+	auto rasterizeTile = [&](
+		const TriangleSetup& t,
+		UINT tileX,
+		UINT tileY)
+	{
+		if (ClassifyTile(t, tileX, tileY, _rasterizer._tileSize) == Outside)
+		{
+			return;
+		}
+
+		XMFLOAT2 tileMinP, tileMaxP;
+		GetTileBounds(
+			tileX, tileY, _rasterizer._tileSize, tileMinP, tileMaxP);
+		RasterTriangle raster;
+		UINT originX, originY, width, height;
+		SetupTileRaster(
+			t,
+			tileMinP,
+			tileMaxP,
+			raster,
+			originX, originY,
+			width, height);
+		_rasterizer._kernels->depth(
+			raster,
+			width,
+			height,
+			depth.data() + originY * view.width + originX,
+			view.width);
+	};
+
+	float perTriangleSetupMS = measure([&](const TriangleSetup& t)
+	{
+		forEachTile(t, [&](UINT tileX, UINT tileY)
+		{
+			rasterizeTile(t, tileX, tileY);
+		});
+	});
+
+	float perTileSetupMS = measure([&](const TriangleSetup& t)
+	{
+		bool clipped = t.barycentrics0.x != 1.0f
+			|| t.barycentrics1.y != 1.0f
+			|| t.barycentrics2.z != 1.0f;
+		forEachTile(t, [&](UINT tileX, UINT tileY)
+		{
+			TriangleSetup tileSetup = t;
+			if (!clipped)
+			{
+				const XMFLOAT3* positionsWS[3] = { &t.p0WS, &t.p1WS, &t.p2WS };
+				ClipVertex vertices[3];
+				for (UINT vertex = 0; vertex < 3; vertex++)
+				{
+					XMStoreFloat4(
+						&vertices[vertex].positionCS,
+						XMVector4Transform(
+							XMVectorSetW(
+								XMLoadFloat3(positionsWS[vertex]),
+								1.0f),
+							VP));
+				}
+				vertices[0].barycentrics = { 1.0f, 0.0f, 0.0f };
+				vertices[1].barycentrics = { 0.0f, 1.0f, 0.0f };
+				vertices[2].barycentrics = { 0.0f, 0.0f, 1.0f };
+				ProjectTriangle(
+					vertices[0],
+					vertices[1],
+					vertices[2],
+					static_cast<float>(view.width),
+					static_cast<float>(view.height),
+					tileSetup);
+			}
+
+			rasterizeTile(tileSetup, tileX, tileY);
+		});
+	});
+
+	Utils::PrintToOutput(
+		"  %s setup per triangle: %.2f ms, per tile: %.2f ms, %s, "
+		"%u clipped triangles set up once\n",
+		_rasterizer._kernels->name,
+		perTriangleSetupMS,
+		perTileSetupMS,
+		(depth == perPixelDepth) ? "same depth" : "DEPTH MISMATCH",
+		clippedTriangles);
+}
+
+void CPURasterizerDiagnostics::BenchmarkShadows(
+	const DrawList* drawLists,
+	UINT drawListsCount,
+	const DrawList* cascadesDrawList)
+{
+	assert(drawListsCount == Settings::FrustumsCount);
+
+	const UINT RunsCount = 8;
+
+	using BinTriangles =
+		void (CPURasterizer::*)(
+			const ViewParams*, UINT, const DrawList&);
+
+	// returns seconds of binning
+	auto drawCascades = [&](
+		BinTriangles binTriangles,
+		UINT firstCascade,
+		UINT cascadesCount,
+		const DrawList& drawList)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		(_rasterizer.*binTriangles)(
+			&_rasterizer._views[1 + firstCascade],
+			cascadesCount,
+			drawList);
+		auto binned = std::chrono::high_resolution_clock::now();
+		for (UINT cascade = firstCascade;
+			cascade < firstCascade + cascadesCount;
+			cascade++)
+		{
+			_rasterizer._rasterizeDepth(
+				_rasterizer._views[1 + cascade],
+				_rasterizer._shadowMaps[cascade].data());
+		}
+
+		return std::chrono::duration<double>(binned - start).count();
+	};
+
+	// of all cascades, per run
+	struct Result
+	{
+		float ms = 0.0f;
+		float setupMS = 0.0f;
+		UINT fetchedVertices = 0;
+	};
+	auto measure = [&](auto&& drawShadows)
+	{
+		for (auto& stats : _rasterizer._stats)
+		{
+			stats = {};
+		}
+
+		double setupSeconds = 0.0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			for (auto& shadowMap : _rasterizer._shadowMaps)
+			{
+				std::fill(shadowMap.begin(), shadowMap.end(), 0.0f);
+			}
+			setupSeconds += drawShadows();
+		}
+		auto finish = std::chrono::high_resolution_clock::now();
+
+		Result result;
+		result.ms = std::chrono::duration<float, std::milli>(
+			finish - start).count() / RunsCount;
+		result.setupMS = static_cast<float>(1e3 * setupSeconds / RunsCount);
+		for (const auto& stats : _rasterizer._stats)
+		{
+			result.fetchedVertices +=
+				stats.counts[CPURasterizer::FetchedVertices];
+		}
+		result.fetchedVertices /= RunsCount;
+
+		return result;
+	};
+
+	auto drawEveryCascade = [&](BinTriangles binTriangles)
+	{
+		double setupSeconds = 0.0;
+		for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+		{
+			setupSeconds += drawCascades(
+				binTriangles,
+				cascade,
+				1,
+				drawLists[1 + cascade]);
+		}
+
+		return setupSeconds;
+	};
+
+	Result general = measure([&]()
+	{
+		return drawEveryCascade(&CPURasterizer::_binTriangles<false>);
+	});
+	std::vector<float> generalShadowMaps[Settings::CascadesCount];
+	for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+	{
+		generalShadowMaps[cascade] = _rasterizer._shadowMaps[cascade];
+	}
+	auto isSameDepth = [&]()
+	{
+		bool sameDepth = true;
+		for (UINT cascade = 0; cascade < Settings::CascadesCount; cascade++)
+		{
+			sameDepth = sameDepth
+				&& _rasterizer._shadowMaps[cascade]
+					== generalShadowMaps[cascade];
+		}
+
+		return sameDepth;
+	};
+
+	Result orthographic = measure([&]()
+	{
+		return drawEveryCascade(&CPURasterizer::_binTriangles<true>);
+	});
+	bool orthographicSameDepth = isSameDepth();
+
+	Utils::PrintToOutput(
+		"CPU rasterizer shadows, %u cascades of %u x %u with %s kernels:\n"
+		"  general: %.2f ms, %.2f ms of it setup, %u vertices fetched\n"
+		"  orthographic: %.2f ms, %.2f ms of it setup, %u vertices fetched, "
+		"%s\n",
+		Settings::CascadesCount,
+		Settings::ShadowMapRes,
+		Settings::ShadowMapRes,
+		_rasterizer._kernels->name,
+		general.ms,
+		general.setupMS,
+		general.fetchedVertices,
+		orthographic.ms,
+		orthographic.setupMS,
+		orthographic.fetchedVertices,
+		orthographicSameDepth ? "same depth" : "DEPTH MISMATCH");
+
+	// the last one, so the shadow maps are the ones of Draw()
+	if (cascadesDrawList)
+	{
+		Result multiView = measure([&]()
+		{
+			return drawCascades(
+				&CPURasterizer::_binTriangles<true>,
+				0,
+				Settings::CascadesCount,
+				*cascadesDrawList);
+		});
+
+		Utils::PrintToOutput(
+			"  multi-view: %.2f ms, %.2f ms of it setup, "
+			"%u vertices fetched, %.1f%% saved, %s\n",
+			multiView.ms,
+			multiView.setupMS,
+			multiView.fetchedVertices,
+			100.0f - 100.0f * multiView.fetchedVertices
+				/ std::max(orthographic.fetchedVertices, 1u),
+			isSameDepth() ? "same depth" : "DEPTH MISMATCH");
+	}
+}
+
+void CPURasterizerDiagnostics::BenchmarkFrontToBack(const DrawList& drawList)
+{
+	const UINT RunsCount = 8;
+
+	bool frontToBack = _rasterizer._frontToBackEnabled;
+	bool inFrameHiZ = _rasterizer._inFrameHiZEnabled;
+
+	// per run
+	struct Result
+	{
+		float ms = 0.0f;
+		float setupMS = 0.0f;
+		UINT skippedTileTriangles = 0;
+		UINT skippedTileMeshlets = 0;
+		UINT64 depthTests = 0;
+		UINT64 depthWrites = 0;
+	};
+	auto measure = [&](bool sort, bool hiZ)
+	{
+		_rasterizer._frontToBackEnabled = sort;
+		_rasterizer._inFrameHiZEnabled = hiZ;
+		for (auto& stats : _rasterizer._stats)
+		{
+			stats = {};
+		}
+
+		double setupSeconds = 0.0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			std::fill(
+				_rasterizer._depthBuffer.begin(),
+				_rasterizer._depthBuffer.end(),
+				0.0f);
+			auto setupStart = std::chrono::high_resolution_clock::now();
+			_rasterizer._binTriangles<false>(
+				&_rasterizer._views[0], 1, drawList);
+			auto binned = std::chrono::high_resolution_clock::now();
+			setupSeconds +=
+				std::chrono::duration<double>(binned - setupStart).count();
+			_rasterizer._rasterizeDepth(
+				_rasterizer._views[0], _rasterizer._depthBuffer.data());
+		}
+		auto finish = std::chrono::high_resolution_clock::now();
+
+		Result result;
+		result.ms = std::chrono::duration<float, std::milli>(
+			finish - start).count() / RunsCount;
+		result.setupMS = static_cast<float>(1e3 * setupSeconds / RunsCount);
+		for (const auto& stats : _rasterizer._stats)
+		{
+			result.skippedTileTriangles +=
+				stats.counts[CPURasterizer::SkippedTileTriangles];
+			result.skippedTileMeshlets +=
+				stats.counts[CPURasterizer::SkippedTileMeshlets];
+		}
+		result.skippedTileTriangles /= RunsCount;
+		result.skippedTileMeshlets /= RunsCount;
+
+		// once more with the same bins, counted, not timed
+		std::vector<float> depth(_rasterizer._depthBuffer.size(), 0.0f);
+		DepthTests = 0;
+		DepthWrites = 0;
+		_rasterizer._rasterizeDepth(
+			_rasterizer._views[0], depth.data(), CountingDepth);
+		result.depthTests = DepthTests;
+		result.depthWrites = DepthWrites;
+
+		return result;
+	};
+
+	Result unsorted = measure(false, false);
+	std::vector<float> unsortedDepth = _rasterizer._depthBuffer;
+
+	Utils::PrintToOutput(
+		"CPU rasterizer front-to-back, camera depth pass of %u x %u "
+		"with %s kernels:\n",
+		_rasterizer._width,
+		_rasterizer._height,
+		_rasterizer._kernels->name);
+
+	for (UINT config = 0; config < 4; config++)
+	{
+		bool sort = (config & 1) != 0;
+		bool hiZ = (config & 2) != 0;
+		Result result = (config == 0) ? unsorted : measure(sort, hiZ);
+
+		// tests are the writes of the GPU path, each an InterlockedMax
+		Utils::PrintToOutput(
+			"  %s%s: %.2f ms, %.2f ms of it setup, "
+			"%llu depth tests, %.1f%% avoided, "
+			"%llu writes, %.1f%% avoided, "
+			"%u triangle tiles and %u meshlet tiles skipped, %s\n",
+			sort ? "sorted" : "unsorted",
+			hiZ ? " with in-frame Hi-Z" : "",
+			result.ms,
+			result.setupMS,
+			result.depthTests,
+			100.0 - 100.0 * result.depthTests
+				/ std::max<UINT64>(unsorted.depthTests, 1),
+			result.depthWrites,
+			100.0 - 100.0 * result.depthWrites
+				/ std::max<UINT64>(unsorted.depthWrites, 1),
+			result.skippedTileTriangles,
+			result.skippedTileMeshlets,
+			(_rasterizer._depthBuffer == unsortedDepth)
+				? "same depth"
+				: "DEPTH MISMATCH");
+	}
+
+	_rasterizer._frontToBackEnabled = frontToBack;
+	_rasterizer._inFrameHiZEnabled = inFrameHiZ;
+}
+
+void CPURasterizerDiagnostics::BenchmarkMicroTriangles(const DrawList& drawList)
+{
+	const UINT RunsCount = 8;
+	const char* SizeNames[CPURasterizer::TriangleSizesCount] =
+	{
+		"1x1",
+		"2x1",
+		"2x2",
+		"up to 4",
+		"up to 8",
+		"up to 16",
+		"up to 32",
+		"larger"
+	};
+
+	bool microTriangles = _rasterizer._microTrianglesEnabled;
+
+	// per run
+	struct Result
+	{
+		float ms = 0.0f;
+		UINT microTriangles = 0;
+		UINT sizes[CPURasterizer::TriangleSizesCount] = {};
+	};
+	auto measure = [&](bool micro)
+	{
+		_rasterizer._microTrianglesEnabled = micro;
+		for (auto& stats : _rasterizer._stats)
+		{
+			stats = {};
+		}
+
+		double seconds = 0.0;
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			std::fill(
+				_rasterizer._depthBuffer.begin(),
+				_rasterizer._depthBuffer.end(),
+				0.0f);
+			_rasterizer._binTriangles<false>(
+				&_rasterizer._views[0], 1, drawList);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			_rasterizer._rasterizeDepth(
+				_rasterizer._views[0], _rasterizer._depthBuffer.data());
+			auto finish = std::chrono::high_resolution_clock::now();
+			seconds += std::chrono::duration<double>(finish - start).count();
+		}
+
+		Result result;
+		result.ms = static_cast<float>(1e3 * seconds / RunsCount);
+		for (const auto& stats : _rasterizer._stats)
+		{
+			result.microTriangles +=
+				stats.counts[CPURasterizer::MicroTriangleTiles];
+			for (UINT size = 0;
+				size < CPURasterizer::TriangleSizesCount;
+				size++)
+			{
+				result.sizes[size] += stats.counts[
+					CPURasterizer::TriangleSizeCounts + size];
+			}
+		}
+		result.microTriangles /= RunsCount;
+		for (UINT& count : result.sizes)
+		{
+			count /= RunsCount;
+		}
+
+		return result;
+	};
+
+	Result kernels = measure(false);
+	std::vector<float> kernelsDepth = _rasterizer._depthBuffer;
+	Result micro = measure(true);
+	bool sameDepth = std::memcmp(
+		_rasterizer._depthBuffer.data(),
+		kernelsDepth.data(),
+		kernelsDepth.size() * sizeof(float)) == 0;
+
+	_rasterizer._microTrianglesEnabled = microTriangles;
+
+	UINT trianglesCount = 0;
+	for (UINT count : micro.sizes)
+	{
+		trianglesCount += count;
+	}
+
+	Utils::PrintToOutput(
+		"CPU rasterizer micro triangles, camera depth pass of %u x %u "
+		"with %s kernels:\n"
+		"  kernels: %.2f ms\n"
+		"  micro triangles: %.2f ms, %u triangle tiles batched, "
+		"%.2f ms saved, %s\n"
+		"  triangles by pixel centers of their bounding box:\n",
+		_rasterizer._width,
+		_rasterizer._height,
+		_rasterizer._kernels->name,
+		kernels.ms,
+		micro.ms,
+		micro.microTriangles,
+		kernels.ms - micro.ms,
+		sameDepth ? "same depth" : "DEPTH MISMATCH");
+	for (UINT size = 0; size < CPURasterizer::TriangleSizesCount; size++)
+	{
+		Utils::PrintToOutput(
+			"    %-8s %8u, %5.1f%%%s\n",
+			SizeNames[size],
+			micro.sizes[size],
+			100.0f * micro.sizes[size] / std::max(trianglesCount, 1u),
+			(size <= CPURasterizer::Size2x2) ? ", micro" : "");
+	}
+}
+
+void CPURasterizerDiagnostics::BenchmarkLayouts(
+	const DrawList* drawLists,
+	UINT drawListsCount)
+{
+	assert(drawListsCount == Settings::FrustumsCount);
+
+	const UINT RunsCount = 8;
+	const UINT BlockSize = RasterizerKernels::BlockSize;
+
+	bool inFrameHiZ = _rasterizer._inFrameHiZEnabled;
+	bool microTriangles = _rasterizer._microTrianglesEnabled;
+	// row-major only, so neither layout takes it
+	_rasterizer._microTrianglesEnabled = false;
+
+	Utils::PrintToOutput(
+		"CPU rasterizer layouts, depth passes with %s kernels, "
+		"tiled into blocks of %u x %u:\n",
+		_rasterizer._kernels->name,
+		BlockSize,
+		BlockSize);
+
+	for (UINT view = 0; view < drawListsCount; view++)
+	{
+		enum Layouts
+		{
+			RowMajor,
+			Tiled,
+			LayoutsCount
+		};
+
+		ViewParams views[LayoutsCount] =
+		{
+			_rasterizer._views[view],
+			_rasterizer._views[view]
+		};
+		views[RowMajor].tiled = false;
+		views[Tiled].tiled = true;
+		UINT width = views[RowMajor].width;
+		UINT height = views[RowMajor].height;
+		std::vector<float> depths[LayoutsCount];
+		depths[RowMajor].resize(width * height);
+		depths[Tiled].resize(RasterizerKernels::TiledSize(width, height));
+
+		if (view == 0)
+		{
+			_rasterizer._binTriangles<false>(
+				&_rasterizer._views[view], 1, drawLists[view]);
+		}
+		else
+		{
+			_rasterizer._binTriangles<true>(
+				&_rasterizer._views[view], 1, drawLists[view]);
+		}
+
+		// ms per run
+		auto measure = [&](auto&& run)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			for (UINT i = 0; i < RunsCount; i++)
+			{
+				run();
+			}
+			auto finish = std::chrono::high_resolution_clock::now();
+
+			return std::chrono::duration<float, std::milli>(
+				finish - start).count() / RunsCount;
+		};
+
+		// [in-frame Hi-Z][layout]
+		float rasterMS[2][LayoutsCount];
+		for (UINT hiZ = 0; hiZ < 2; hiZ++)
+		{
+			_rasterizer._inFrameHiZEnabled = hiZ != 0;
+			for (UINT layout = 0; layout < LayoutsCount; layout++)
+			{
+				rasterMS[hiZ][layout] = measure([&]()
+				{
+					std::fill(
+						depths[layout].begin(),
+						depths[layout].end(),
+						0.0f);
+					_rasterizer._rasterizeDepth(
+						views[layout], depths[layout].data());
+				});
+			}
+		}
+
+		// every block of the final depths, on a single worker
+		UINT blocksX = RasterizerKernels::TiledBlocksCount(width);
+		UINT blocksY = RasterizerKernels::TiledBlocksCount(height);
+		float hiZMS[LayoutsCount];
+		for (UINT layout = 0; layout < LayoutsCount; layout++)
+		{
+			hiZMS[layout] = measure([&]()
+			{
+				for (UINT blockY = 0; blockY < blocksY; blockY++)
+				{
+					for (UINT blockX = 0; blockX < blocksX; blockX++)
+					{
+						_rasterizer._inFrameHiZ[blockY * blocksX + blockX] =
+							_rasterizer._getBlockDepth(
+								views[layout],
+								depths[layout].data(),
+								blockX,
+								blockY);
+					}
+				}
+			});
+		}
+
+		std::vector<float> detiled(width * height);
+		float detileMS = measure([&]()
+		{
+			RasterizerKernels::Detile(
+				depths[Tiled].data(),
+				width,
+				0,
+				height,
+				detiled.data());
+		});
+
+		char name[32];
+		if (view == 0)
+		{
+			sprintf_s(name, "camera");
+		}
+		else
+		{
+			sprintf_s(name, "cascade %u", view - 1);
+		}
+		Utils::PrintToOutput(
+			"  %s, %u x %u:\n"
+			"    raster: row-major %.2f ms, tiled %.2f ms\n"
+			"    raster with in-frame Hi-Z: row-major %.2f ms, "
+			"tiled %.2f ms\n"
+			"    Hi-Z blocks: row-major %.2f ms, tiled %.2f ms, "
+			"detile %.2f ms, %s\n",
+			name,
+			width,
+			height,
+			rasterMS[0][RowMajor],
+			rasterMS[0][Tiled],
+			rasterMS[1][RowMajor],
+			rasterMS[1][Tiled],
+			hiZMS[RowMajor],
+			hiZMS[Tiled],
+			detileMS,
+			(detiled == depths[RowMajor]) ? "same depth" : "DEPTH MISMATCH");
+	}
+
+	_rasterizer._inFrameHiZEnabled = inFrameHiZ;
+	_rasterizer._microTrianglesEnabled = microTriangles;
+}
+
+void CPURasterizerDiagnostics::BenchmarkHiZ()
+{
+	const UINT RunsCount = 16;
+
+	enum Builds
+	{
+		PerMip,
+		SinglePass,
+		BuildsCount
+	};
+	const RasterizerKernels::Kernels* kernels[] =
+	{
+		&RasterizerKernels::Get(RasterizerKernels::Scalar),
+		_rasterizer._kernels
+	};
+
+	Utils::PrintToOutput(
+		"CPU Hi-Z pyramids of the last frame, %u workers, "
+		"bands of %u rows:\n",
+		_rasterizer._threadPool.GetWorkersCount(),
+		HiZPyramid::BandRows);
+
+	for (UINT view = 0; view < Settings::FrustumsCount; view++)
+	{
+		UINT width = _rasterizer._views[view].width;
+		UINT height = _rasterizer._views[view].height;
+		bool tiled = _rasterizer._views[view].tiled;
+		const float* depth = (view == 0)
+			? _rasterizer._depthBuffer.data()
+			: _rasterizer._shadowMaps[view - 1].data();
+
+		HiZPyramid reference;
+		reference.BuildPerMip(
+			_rasterizer._threadPool,
+			*kernels[0],
+			depth,
+			width,
+			height,
+			tiled);
+
+		HiZPyramid pyramid;
+		bool sameMips = true;
+		// [build][kernels], ms per run
+		float buildMS[BuildsCount][_countof(kernels)];
+		for (UINT build = 0; build < BuildsCount; build++)
+		{
+			for (UINT k = 0; k < _countof(kernels); k++)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				for (UINT i = 0; i < RunsCount; i++)
+				{
+					if (build == PerMip)
+					{
+						pyramid.BuildPerMip(
+							_rasterizer._threadPool,
+							*kernels[k],
+							depth,
+							width,
+							height,
+							tiled);
+					}
+					else
+					{
+						pyramid.Build(
+							_rasterizer._threadPool,
+							*kernels[k],
+							depth,
+							width,
+							height,
+							tiled);
+					}
+				}
+				auto finish = std::chrono::high_resolution_clock::now();
+				buildMS[build][k] = std::chrono::duration<float, std::milli>(
+					finish - start).count() / RunsCount;
+
+				for (UINT mip = 0; mip < reference.GetMipsCount(); mip++)
+				{
+					UINT texelsCount = reference.GetMipWidth(mip)
+						* reference.GetMipHeight(mip);
+					const float* minTexels = reference.GetMinMip(mip);
+					const float* maxTexels = reference.GetMaxMip(mip);
+					sameMips = sameMips
+						&& std::equal(
+							minTexels,
+							minTexels + texelsCount,
+							pyramid.GetMinMip(mip))
+						&& std::equal(
+							maxTexels,
+							maxTexels + texelsCount,
+							pyramid.GetMaxMip(mip));
+				}
+			}
+		}
+
+		char name[32];
+		if (view == 0)
+		{
+			sprintf_s(name, "camera");
+		}
+		else
+		{
+			sprintf_s(name, "cascade %u", view - 1);
+		}
+		Utils::PrintToOutput(
+			"  %s, %u x %u, %u mips:\n"
+			"    a mip at a time: %s %.3f ms, %s %.3f ms\n"
+			"    single traversal: %s %.3f ms, %s %.3f ms, %s\n",
+			name,
+			width,
+			height,
+			reference.GetMipsCount(),
+			kernels[0]->name,
+			buildMS[PerMip][0],
+			kernels[1]->name,
+			buildMS[PerMip][1],
+			kernels[0]->name,
+			buildMS[SinglePass][0],
+			kernels[1]->name,
+			buildMS[SinglePass][1],
+			sameMips ? "same mips" : "MIPS MISMATCH");
+	}
+}
+
+void CPURasterizerDiagnostics::BenchmarkShading(const DrawList& drawList)
+{
+	const UINT RunsCount = 8;
+	// of a color channel, float rounding differs between the two
+	const float Tolerance = 0.01f;
+
+	bool attributePlanes = _rasterizer._attributePlanesEnabled;
+	bool triangleCompaction = _rasterizer._triangleCompactionEnabled;
+	_rasterizer._triangleCompactionEnabled = false;
+
+	std::fill(
+		_rasterizer._depthBuffer.begin(),
+		_rasterizer._depthBuffer.end(),
+		0.0f);
+	_rasterizer._binTriangles<false>(&_rasterizer._views[0], 1, drawList);
+	_rasterizer._rasterizeDepth(
+		_rasterizer._views[0], _rasterizer._depthBuffer.data());
+
+	// shaded pixels per second
+	auto measure = [&](bool planes)
+	{
+		_rasterizer._attributePlanesEnabled = planes;
+		for (auto& stats : _rasterizer._stats)
+		{
+			stats = {};
+		}
+
+		double seconds = 0.0;
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			std::fill(
+				_rasterizer._renderTarget.begin(),
+				_rasterizer._renderTarget.end(),
+				XMFLOAT4(SkyColor));
+
+			auto start = std::chrono::high_resolution_clock::now();
+			_rasterizer._rasterizeOpaque(drawList);
+			auto finish = std::chrono::high_resolution_clock::now();
+			seconds += std::chrono::duration<double>(finish - start).count();
+		}
+
+		UINT64 pixels = 0;
+		for (const auto& stats : _rasterizer._stats)
+		{
+			pixels += stats.counts[CPURasterizer::ShadedPixels];
+		}
+
+		return static_cast<float>(pixels / seconds / 1e6);
+	};
+
+	float weightsMPixels = measure(false);
+	std::vector<XMFLOAT4> weightsResult = _rasterizer._renderTarget;
+	float planesMPixels = measure(true);
+
+	UINT differentPixels = 0;
+	float maxError = 0.0f;
+	for (size_t pixel = 0; pixel < weightsResult.size(); pixel++)
+	{
+		const XMFLOAT4& a = weightsResult[pixel];
+		const XMFLOAT4& b = _rasterizer._renderTarget[pixel];
+		float error = std::max({
+			std::abs(a.x - b.x),
+			std::abs(a.y - b.y),
+			std::abs(a.z - b.z) });
+		maxError = std::max(maxError, error);
+		differentPixels += error > Tolerance ? 1 : 0;
+	}
+
+	_rasterizer._attributePlanesEnabled = attributePlanes;
+	_rasterizer._triangleCompactionEnabled = triangleCompaction;
+
+	Utils::PrintToOutput(
+		"CPU rasterizer shading, camera of %u x %u with %s kernels:\n"
+		"  barycentric weights: %.1f Mpixels/s\n"
+		"  attribute planes: %.1f Mpixels/s, %.2fx, "
+		"%u pixels differ by more than %.2f, max %.4f\n",
+		_rasterizer._width,
+		_rasterizer._height,
+		_rasterizer._kernels->name,
+		weightsMPixels,
+		planesMPixels,
+		planesMPixels / weightsMPixels,
+		differentPixels,
+		Tolerance,
+		maxError);
+}
+
+void CPURasterizerDiagnostics::BenchmarkTriangleCompaction(
+	const DrawList& drawList)
+{
+	const UINT RunsCount = 8;
+
+	bool triangleCompaction = _rasterizer._triangleCompactionEnabled;
+
+	// per run
+	struct Result
+	{
+		float depthMS = 0.0f;
+		float filterMS = 0.0f;
+		float opaqueMS = 0.0f;
+		UINT compactedTriangles = 0;
+		UINT filteredTriangles = 0;
+		size_t bytes = 0;
+	};
+	auto measure = [&](bool compaction)
+	{
+		_rasterizer._triangleCompactionEnabled = compaction;
+		for (auto& stats : _rasterizer._stats)
+		{
+			stats = {};
+		}
+
+		Result result;
+		double seconds[3] = {};
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			std::fill(
+				_rasterizer._depthBuffer.begin(),
+				_rasterizer._depthBuffer.end(),
+				0.0f);
+			std::fill(
+				_rasterizer._renderTarget.begin(),
+				_rasterizer._renderTarget.end(),
+				XMFLOAT4(SkyColor));
+			_rasterizer._binTriangles<false>(
+				&_rasterizer._views[0], 1, drawList);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			_rasterizer._rasterizeDepth(
+				_rasterizer._views[0],
+				_rasterizer._depthBuffer.data(),
+				nullptr,
+				compaction ? _rasterizer._compactedTriangles : nullptr);
+			auto depthFinish = std::chrono::high_resolution_clock::now();
+			if (compaction)
+			{
+				_rasterizer._filterCompactedTriangles();
+			}
+			auto filterFinish = std::chrono::high_resolution_clock::now();
+			_rasterizer._rasterizeOpaque(drawList);
+			auto finish = std::chrono::high_resolution_clock::now();
+
+			seconds[0] +=
+				std::chrono::duration<double>(depthFinish - start).count();
+			seconds[1] += std::chrono::duration<double>(
+				filterFinish - depthFinish).count();
+			seconds[2] +=
+				std::chrono::duration<double>(finish - filterFinish).count();
+		}
+
+		result.depthMS = static_cast<float>(1e3 * seconds[0] / RunsCount);
+		result.filterMS = static_cast<float>(1e3 * seconds[1] / RunsCount);
+		result.opaqueMS = static_cast<float>(1e3 * seconds[2] / RunsCount);
+		for (const auto& stats : _rasterizer._stats)
+		{
+			result.compactedTriangles +=
+				stats.counts[CPURasterizer::CompactedTriangles];
+			result.filteredTriangles +=
+				stats.counts[CPURasterizer::FilteredTriangles];
+		}
+		result.compactedTriangles /= RunsCount;
+		result.filteredTriangles /= RunsCount;
+		for (const auto& tiles : _rasterizer._compactedTriangles)
+		{
+			for (const auto& triangles : tiles)
+			{
+				result.bytes += triangles.capacity()
+					* sizeof(CPURasterizer::CompactTriangle);
+			}
+		}
+
+		return result;
+	};
+
+	Result bins = measure(false);
+	std::vector<XMFLOAT4> binsResult = _rasterizer._renderTarget;
+	Result compacted = measure(true);
+	bool sameResult = std::memcmp(
+		_rasterizer._renderTarget.data(),
+		binsResult.data(),
+		binsResult.size() * sizeof(XMFLOAT4)) == 0;
+
+	_rasterizer._triangleCompactionEnabled = triangleCompaction;
+
+	float binsMS = bins.depthMS + bins.opaqueMS;
+	float compactedMS =
+		compacted.depthMS + compacted.filterMS + compacted.opaqueMS;
+	Utils::PrintToOutput(
+		"CPU rasterizer triangle compaction, camera of %u x %u "
+		"with %s kernels:\n"
+		"  bins: %.2f ms, depth %.2f ms, opaque %.2f ms\n"
+		"  compacted: %.2f ms, depth %.2f ms, filter %.2f ms, "
+		"opaque %.2f ms, %u triangle tiles kept, %u filtered, "
+		"%.1f KB, %.2f ms saved, %s\n",
+		_rasterizer._width,
+		_rasterizer._height,
+		_rasterizer._kernels->name,
+		binsMS,
+		bins.depthMS,
+		bins.opaqueMS,
+		compactedMS,
+		compacted.depthMS,
+		compacted.filterMS,
+		compacted.opaqueMS,
+		compacted.compactedTriangles,
+		compacted.filteredTriangles,
+		compacted.bytes / 1024.0f,
+		binsMS - compactedMS,
+		sameResult ? "same result" : "RESULT MISMATCH");
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CPURasterizer.h"
+
+// benchmarks and correctness checks of the CPU rasterizer,
+// run on the state of its last Draw() and logged to the output,
+// kept out of the rasterizer, which only befriends them
+class CPURasterizerDiagnostics
+{
+public:
+
+	typedef CPURasterizer::DrawList DrawList;
+
+	// need the draw lists of a frame, so they are requested
+	// and then run after the frame's Draw(), see RunRequests
+	enum FrameBenchmarks
+	{
+		ShadowsBenchmark,
+		FrontToBackBenchmark,
+		TriangleCompactionBenchmark,
+		ShadingBenchmark,
+		MicroTrianglesBenchmark,
+		LayoutsBenchmark,
+		HiZBenchmark,
+		FrameBenchmarksCount
+	};
+
+	explicit CPURasterizerDiagnostics(CPURasterizer& rasterizer);
+	CPURasterizerDiagnostics(const CPURasterizerDiagnostics&) = delete;
+	CPURasterizerDiagnostics& operator=(
+		const CPURasterizerDiagnostics&) = delete;
+	~CPURasterizerDiagnostics() = default;
+
+	void Request(FrameBenchmarks benchmark)
+	{
+		_requested[benchmark] = true;
+	}
+	bool HasRequests() const;
+	// the lists given to the last Draw()
+	void RunRequests(
+		const DrawList* drawLists,
+		UINT drawListsCount,
+		const DrawList* cascadesDrawList);
+
+	// pixels per second of every supported kernel,
+	// for triangles from 1 to 4096 pixels
+	void BenchmarkKernels();
+	// rasterizes jittered grids of triangles with every supported kernel,
+	// logs pixels not covered exactly once
+	void CheckWatertightness();
+	// rasterizes a box around the camera looking in many directions,
+	// logs pixels not covered exactly once
+	void CheckClipping();
+	// coarse rasterization against testing every pixel of every tile,
+	// as BigTriangleDepthCS does, and setting up once per triangle against
+	// once per tile, for the camera's triangles spanning several tiles
+	// in the last Draw(), meant for the Plant scene
+	void BenchmarkBigTriangles();
+	// rasterizes the cascades of the given draw lists, as Draw() does,
+	// with the orthographic setup and with the general one,
+	// and with cascadesDrawList in a single sweep if given
+	void BenchmarkShadows(
+		const DrawList* drawLists,
+		UINT drawListsCount,
+		const DrawList* cascadesDrawList = nullptr);
+	// depth pass of the camera's draw list unsorted and sorted
+	// front-to-back, with and without the in-frame Hi-Z,
+	// logs the depth writes of each
+	void BenchmarkFrontToBack(const DrawList& drawList);
+	// depth pass of the camera's draw list with and without
+	// the micro triangle path, logs the histogram of triangle sizes
+	void BenchmarkMicroTriangles(const DrawList& drawList);
+	// depth passes of the camera and the cascades into row-major
+	// and tiled targets, with and without the in-frame Hi-Z,
+	// and the Hi-Z blocks reduced from each, logs the times
+	void BenchmarkLayouts(const DrawList* drawLists, UINT drawListsCount);
+	// Hi-Z pyramids of the camera's depth and the cascades of the last
+	// Draw(), built a mip at a time and in a single traversal,
+	// with the scalar and the current kernels, logs the times
+	void BenchmarkHiZ();
+	// camera's opaque pass with and without the attribute planes,
+	// logs shaded pixels per second
+	void BenchmarkShading(const DrawList& drawList);
+	// camera's depth and opaque passes with and without
+	// the compacted triangles, logs the time saved
+	void BenchmarkTriangleCompaction(const DrawList& drawList);
+
+private:
+
+	typedef CPURasterizer::ViewParams ViewParams;
+	typedef CPURasterizer::TriangleSetup TriangleSetup;
+
+	CPURasterizer& _rasterizer;
+	bool _requested[FrameBenchmarksCount] = {};
+};
\ No newline at end of file
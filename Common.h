@@ -1,20 +1,20 @@
-#pragma once
-
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN // Exclude rarely-used stuff from Windows headers.
-#endif
-
-#define NOMINMAX
-#include <windows.h>
-
-#include <d3d12.h>
-#include <dxgi1_6.h>
-#include <D3Dcompiler.h>
-#include <DirectXMath.h>
-#include "d3dx12.h"
-#include <pix_win.h>
-
-#include <string>
-#include <memory>
-#include <wrl.h>
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN // Exclude rarely-used stuff from Windows headers.
+#endif
+
+#define NOMINMAX
+#include <windows.h>
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <D3Dcompiler.h>
+#include <DirectXMath.h>
+#include "d3dx12.h"
+#include <pix_win.h>
+
+#include <string>
+#include <memory>
+#include <wrl.h>
 #include <shellapi.h>
\ No newline at end of file
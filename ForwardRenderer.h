@@ -1,100 +1,147 @@
-#pragma once
-
-#include "DXSample.h"
-#include "Timer.h"
-#include "Profiler.h"
-#include "Settings.h"
-#include "Shadows.h"
-#include "Culler.h"
-#include "HardwareRasterization.h"
-#include "SoftwareRasterization.h"
-#include "Scene.h"
-
-class ForwardRenderer : public DXSample
-{
-public:
-
-	ForwardRenderer(UINT width, UINT height, std::wstring name);
-
-	virtual void OnInit();
-	virtual void OnUpdate();
-	virtual void OnRender();
-	virtual void OnSizeChanged(UINT width, UINT height, bool minimized);
-	virtual void OnDestroy();
-
-	void OnKeyboardInput();
-	virtual void OnMouseMove(UINT x, UINT y);
-	virtual void OnRightButtonDown(UINT x, UINT y);
-	virtual void OnKeyDown(UINT8 key);
-
-	void PreparePrevFrameDepth(ID3D12Resource* depth);
-	ID3D12Resource* GetCulledCommands(UINT frame, UINT frustum)
-	{
-		assert(frame >= 0);
-		assert(frame < DX::FramesCount);
-		assert(frustum >= 0);
-		assert(frustum < Settings::FrustumsCount);
-		return _culledCommands[frame][frustum].Get();
-	}
-	ID3D12Resource* GetCulledCommandsCounter(UINT frame, UINT frustum)
-	{
-		assert(frame >= 0);
-		assert(frame < DX::FramesCount);
-		assert(frustum >= 0);
-		assert(frustum < Settings::FrustumsCount);
-		return _culledCommandsCounters[frame][frustum].Get();
-	}
-
-private:
-
-	void _loadAssets();
-	void _moveToNextFrame();
-	void _waitForGpu();
-	void _createDescriptorHeaps();
-	void _createFrameResources();
-	void _createSwapChain();
-	void _createVisibleInstancesBuffer();
-	void _createDepthBufferResources();
-	void _createCulledCommandsBuffers();
-
-	void _initGUI();
-	void _GUINewFrame();
-	void _drawGUI();
-	void _destroyGUI();
-
-	void _beginFrameRendering();
-	void _finishFrameRendering();
-	void _onRasterizerSwitch();
-	void _softwareRasterization();
-
-	Microsoft::WRL::ComPtr<IDXGISwapChain3> _swapChain;
-	Microsoft::WRL::ComPtr<ID3D12Resource> _renderTargets[DX::FramesCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_visibleInstances[DX::FramesCount][Settings::FrustumsCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource> _prevFrameDepthBuffer;
-	// per frame granularity for async compute and graphics work
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_culledCommands[DX::FramesCount][Settings::FrustumsCount];
-	// first 4 bytes used as a counter
-	// all 12 bytes are used as a dispatch indirect command
-	// [0] - counter / group count X
-	// [1] - group count Y
-	// [2] - group count Z
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_culledCommandsCounters[DX::FramesCount][Settings::FrustumsCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_culledCommandsCountersUpload[DX::FramesCount][Settings::FrustumsCount];
-
-	std::unique_ptr<Culler> _culler;
-	std::unique_ptr<HardwareRasterization> _HWR;
-	std::unique_ptr<SoftwareRasterization> _SWR;
-	std::unique_ptr<FrameStatistics> _stats;
-	std::unique_ptr<Profiler> _profiler;
-	DXGI_QUERY_VIDEO_MEMORY_INFO _GPUMemoryInfo;
-	DXGI_QUERY_VIDEO_MEMORY_INFO _CPUMemoryInfo;
-	Timer _timer;
-	POINT _lastMousePos;
-
-	bool _switchToSWR = false;
-	bool _switchFromSWR = false;
+#pragma once
+
+#include "DXSample.h"
+#include "Timer.h"
+#include "Profiler.h"
+#include "Settings.h"
+#include "Shadows.h"
+#include "Culler.h"
+#include "CPUCuller.h"
+#include "CPURasterizer.h"
+#include "CPURasterizerDiagnostics.h"
+#include "HardwareRasterization.h"
+#include "SoftwareRasterization.h"
+#include "Scene.h"
+
+class ForwardRenderer : public DXSample
+{
+public:
+
+	ForwardRenderer(UINT width, UINT height, std::wstring name);
+
+	virtual void OnInit();
+	virtual void OnUpdate();
+	virtual void OnRender();
+	virtual void OnSizeChanged(UINT width, UINT height, bool minimized);
+	virtual void OnDestroy();
+
+	void OnKeyboardInput();
+	virtual void OnMouseMove(UINT x, UINT y);
+	virtual void OnRightButtonDown(UINT x, UINT y);
+	virtual void OnKeyDown(UINT8 key);
+
+	void PreparePrevFrameDepth(ID3D12Resource* depth);
+	ID3D12Resource* GetCulledCommands(UINT frame, UINT frustum)
+	{
+		assert(frame >= 0);
+		assert(frame < DX::FramesCount);
+		assert(frustum >= 0);
+		assert(frustum < Settings::FrustumsCount);
+		return _culledCommands[frame][frustum].Get();
+	}
+	ID3D12Resource* GetCulledCommandsCounter(UINT frame, UINT frustum)
+	{
+		assert(frame >= 0);
+		assert(frame < DX::FramesCount);
+		assert(frustum >= 0);
+		assert(frustum < Settings::FrustumsCount);
+		return _culledCommandsCounters[frame][frustum].Get();
+	}
+
+private:
+
+	void _loadAssets();
+	void _moveToNextFrame();
+	void _waitForGpu();
+	void _createDescriptorHeaps();
+	void _createFrameResources();
+	void _createSwapChain();
+	void _createVisibleInstancesBuffer();
+	void _createDepthBufferResources();
+	void _createCulledCommandsBuffers();
+	void _createRoutedCommandsBuffers();
+	void _updateCullingViews();
+	void _uploadRoutedCommands();
+	void _profileCPUCulling();
+	void _evaluateHybridRouting();
+	void _evaluateHiZCulling();
+	void _evaluateMeshletBounds();
+	void _drawCPURasterizer();
+	void _compareRasterizers();
+	void _compareCPURasterizerVisibilityBuffer();
+
+	void _initGUI();
+	void _GUINewFrame();
+	void _drawGUI();
+	void _drawDiagnosticsGUI();
+	void _destroyGUI();
+
+	void _beginFrameRendering();
+	void _finishFrameRendering();
+	void _onRasterizerSwitch();
+	void _softwareRasterization();
+
+	Microsoft::WRL::ComPtr<IDXGISwapChain3> _swapChain;
+	Microsoft::WRL::ComPtr<ID3D12Resource> _renderTargets[DX::FramesCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_visibleInstances[DX::FramesCount][Settings::FrustumsCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource> _prevFrameDepthBuffer;
+	// per frame granularity for async compute and graphics work
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_culledCommands[DX::FramesCount][Settings::FrustumsCount];
+	// first 4 bytes used as a counter
+	// all 12 bytes are used as a dispatch indirect command
+	// [0] - counter / group count X
+	// [1] - group count Y
+	// [2] - group count Z
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_culledCommandsCounters[DX::FramesCount][Settings::FrustumsCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_culledCommandsCountersUpload[DX::FramesCount][Settings::FrustumsCount];
+	// the camera meshlets routed by the CPU culler to the rasterizer in use,
+	// copied over the GPU culled ones of the camera
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_routedInstancesUpload[DX::FramesCount];
+	Instance* _routedInstancesData[DX::FramesCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_routedCommandsUpload[DX::FramesCount];
+	IndirectCommand* _routedCommandsData[DX::FramesCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_routedCommandsCounterUpload[DX::FramesCount];
+	UINT* _routedCommandsCounterData[DX::FramesCount];
+
+	std::unique_ptr<Culler> _culler;
+	std::unique_ptr<CPUCuller> _CPUCuller;
+	// camera + cascades, the first _cullingViewsCount are culled
+	CullingView _cullingViews[Settings::MaxViewsCount];
+	UINT _cullingViewsCount = 0;
+	std::unique_ptr<HardwareRasterization> _HWR;
+	std::unique_ptr<SoftwareRasterization> _SWR;
+	std::unique_ptr<CPURasterizer> _CPURasterizer;
+	std::unique_ptr<CPURasterizerDiagnostics> _CPURasterizerDiagnostics;
+	std::unique_ptr<FrameStatistics> _stats;
+	std::unique_ptr<Profiler> _profiler;
+	DXGI_QUERY_VIDEO_MEMORY_INFO _GPUMemoryInfo;
+	DXGI_QUERY_VIDEO_MEMORY_INFO _CPUMemoryInfo;
+	Timer _timer;
+	POINT _lastMousePos;
+
+	bool _switchToSWR = false;
+	bool _switchFromSWR = false;
+	bool _compareRasterizersRequested = false;
+	bool _hybridRoutingEnabled = false;
+	// pixels per triangle, the cost model crossover by default
+	float _hybridRoutingThreshold = 0.0f;
+	bool _autoTuneCPURasterizer = false;
+	bool _CPURasterizerVisibilityBuffer = false;
+	bool _CPURasterizerMultiViewShadows = false;
+	bool _CPURasterizerVertexCache = false;
+	bool _CPURasterizerFrontToBack = false;
+	bool _CPURasterizerInFrameHiZ = false;
+	bool _CPURasterizerTriangleCompaction = false;
+	bool _CPURasterizerAttributePlanes = false;
+	bool _CPURasterizerMicroTriangles = false;
+	bool _CPURasterizerTiledShadowMaps = false;
+	bool _CPURasterizerHiZCulling = false;
+	int _CPUHiZTest = HiZPyramid::FootprintTaps;
 };
\ No newline at end of file
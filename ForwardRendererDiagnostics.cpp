@@ -0,0 +1,530 @@
+#include "ForwardRenderer.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+// how CPU culling cost scales with the views count,
+// from the camera alone to the camera and all the cascades
+void ForwardRenderer::_profileCPUCulling()
+{
+	const UINT RunsCount = 10;
+
+	Utils::PrintToOutput("CPU culling profile:\n");
+	for (UINT viewsCount = 1;
+		viewsCount <= _cullingViewsCount;
+		viewsCount++)
+	{
+		_CPUCuller->Update(_cullingViews, viewsCount);
+
+		float totalTime = 0.0f;
+		for (UINT run = 0; run < RunsCount; run++)
+		{
+			_CPUCuller->Cull();
+			totalTime += _CPUCuller->GetCullingTimeMS();
+		}
+
+		UINT visibleInstances = 0;
+		for (UINT view = 0; view < viewsCount; view++)
+		{
+			visibleInstances += _CPUCuller->GetVisibleInstancesCount(view);
+		}
+
+		Utils::PrintToOutput(
+			"%u views: %.3f ms, %u visible instances\n",
+			viewsCount,
+			totalTime / RunsCount,
+			visibleInstances);
+	}
+
+	_CPUCuller->Update(_cullingViews, _cullingViewsCount);
+}
+
+// predicted frame cost of splitting the camera view of each scene
+// between the software and hardware rasterizers
+void ForwardRenderer::_evaluateHybridRouting()
+{
+	Scene* currentScene = Scene::CurrentScene;
+	Scene* scenes[] = { &Scene::BuddhaScene, &Scene::PlantScene };
+	const char* scenesNames[] = { "Buddha", "Plant" };
+
+	for (UINT scene = 0; scene < _countof(scenes); scene++)
+	{
+		Scene::CurrentScene = scenes[scene];
+		Camera& camera = Scene::CurrentScene->camera;
+		if (Scene::CurrentScene != currentScene)
+		{
+			// not updated while the scene is not shown
+			camera.UpdateViewMatrix();
+		}
+
+		// of the scene's camera, the views are of the current scene only
+		CullingView view = _cullingViews[0];
+		view.frustum = camera.GetFrustum();
+		view.VP = camera.GetVP();
+		view.position = camera.GetPosition();
+
+		_CPUCuller->Update(&view, 1);
+		_CPUCuller->SetHybridRouting(true, 0.0f);
+		_CPUCuller->Cull();
+
+		HybridRouting::PrintEvaluation(
+			scenesNames[scene],
+			HybridRouting::Evaluate(
+				_CPUCuller->GetMeshletEstimates(0),
+				HybridRouting::CostModel()));
+	}
+
+	Scene::CurrentScene = currentScene;
+	_CPUCuller->SetHybridRouting(false, 0.0f);
+	_CPUCuller->Update(_cullingViews, _cullingViewsCount);
+}
+
+// extra instances and triangles culled by the min/max Hi-Z of the
+// previous Draw() with each test, and the depth pixels they change
+void ForwardRenderer::_evaluateHiZCulling()
+{
+	Scene* currentScene = Scene::CurrentScene;
+	Scene* scenes[] = { &Scene::BuddhaScene, &Scene::PlantScene };
+	const char* scenesNames[] = { "Buddha", "Plant" };
+	// the conservative ones first, they keep the pyramids unchanged
+	HiZPyramid::Tests tests[] =
+	{
+		HiZPyramid::ExactTaps,
+		HiZPyramid::FootprintTaps,
+		HiZPyramid::CenterTap
+	};
+	const bool HiZCullingEnabled = _CPURasterizer->IsHiZCulling();
+	const HiZPyramid::Tests HiZTest = _CPURasterizer->GetHiZTest();
+
+	if (!Settings::CullingEnabled)
+	{
+		Utils::PrintToOutput(
+			"CPU Hi-Z culling: culling disabled, "
+			"only the triangles are tested\n");
+	}
+
+	for (UINT scene = 0; scene < _countof(scenes); scene++)
+	{
+		Scene::CurrentScene = scenes[scene];
+		if (Scene::CurrentScene != currentScene)
+		{
+			// not updated while the scene is not shown
+			Scene::CurrentScene->camera.UpdateViewMatrix();
+			ShadowsResources::Shadows.Update();
+		}
+
+		_updateCullingViews();
+		CullingView views[Settings::MaxViewsCount];
+		for (UINT view = 0; view < _cullingViewsCount; view++)
+		{
+			views[view] = _cullingViews[view];
+			views[view].HiZCullingEnabled = 1;
+		}
+		_CPUCuller->Update(views, _cullingViewsCount);
+		_CPURasterizer->Update();
+
+		// nothing is tested before the pyramids are built
+		_CPURasterizer->SetHiZCulling(true);
+		_drawCPURasterizer();
+		const std::vector<float> referenceDepth =
+			_CPURasterizer->GetDepthBuffer();
+		const UINT pipelineTriangles =
+			_CPURasterizer->GetPipelineTrianglesCount();
+		UINT visibleInstances = 0;
+		for (UINT view = 0; view < _cullingViewsCount; view++)
+		{
+			visibleInstances += _CPUCuller->GetVisibleInstancesCount(view);
+		}
+
+		Utils::PrintToOutput(
+			"CPU Hi-Z culling, %s: %u visible instances, "
+			"%u pipeline triangles\n",
+			scenesNames[scene],
+			visibleInstances,
+			pipelineTriangles);
+
+		UINT footprintInstances = 0;
+		UINT footprintTriangles = 0;
+		for (HiZPyramid::Tests test : tests)
+		{
+			_CPURasterizer->SetHiZTest(test);
+			_CPUCuller->SetHiZTest(test);
+			_drawCPURasterizer();
+
+			UINT occludedInstances = 0;
+			for (UINT view = 0; view < _cullingViewsCount; view++)
+			{
+				occludedInstances += _CPUCuller->GetHiZOccludedCount(view);
+			}
+			const UINT occludedTriangles =
+				_CPURasterizer->GetRejectedTrianglesCount(
+					CPURasterizer::HiZOccluded);
+
+			const auto& depth = _CPURasterizer->GetDepthBuffer();
+			UINT changedPixels = 0;
+			for (size_t pixel = 0; pixel < depth.size(); pixel++)
+			{
+				changedPixels += (depth[pixel] != referenceDepth[pixel]);
+			}
+
+			const float instancesRate = visibleInstances
+				? 100.0f * occludedInstances / visibleInstances
+				: 0.0f;
+			const float trianglesRate = pipelineTriangles
+				? 100.0f * occludedTriangles / pipelineTriangles
+				: 0.0f;
+			Utils::PrintToOutput(
+				"%s: %u instances (%.2f%%), %u triangles (%.2f%%) culled, "
+				"%u depth pixels changed\n",
+				HiZPyramid::GetTestName(test),
+				occludedInstances,
+				instancesRate,
+				occludedTriangles,
+				trianglesRate,
+				changedPixels);
+
+			if (test == HiZPyramid::FootprintTaps)
+			{
+				footprintInstances = occludedInstances;
+				footprintTriangles = occludedTriangles;
+			}
+			else if (test == HiZPyramid::CenterTap)
+			{
+				Utils::PrintToOutput(
+					"2x2 footprint extra culling: %d instances, "
+					"%d triangles\n",
+					static_cast<int>(footprintInstances - occludedInstances),
+					static_cast<int>(footprintTriangles - occludedTriangles));
+			}
+		}
+	}
+
+	Scene::CurrentScene = currentScene;
+	Scene::CurrentScene->camera.UpdateViewMatrix();
+	ShadowsResources::Shadows.Update();
+	_updateCullingViews();
+	_CPUCuller->Update(_cullingViews, _cullingViewsCount);
+	_CPUCuller->SetHiZTest(HiZTest);
+	_CPURasterizer->Update();
+	_CPURasterizer->SetHiZTest(HiZTest);
+	_CPURasterizer->SetHiZCulling(HiZCullingEnabled);
+}
+
+// instances culled by the frustum and by the Hi-Z of the CPU rasterizer
+// with the tight meshlet AABBs and with the sphere-derived cubes,
+// of the camera and of the cascades of each scene
+void ForwardRenderer::_evaluateMeshletBounds()
+{
+	Scene* currentScene = Scene::CurrentScene;
+	Scene* scenes[] = { &Scene::BuddhaScene, &Scene::PlantScene };
+	const char* scenesNames[] = { "Buddha", "Plant" };
+	const char* boundsNames[] = { "tight AABBs", "sphere-derived cubes" };
+	const bool HiZCullingEnabled = _CPURasterizer->IsHiZCulling();
+
+	if (!Settings::FrustumCullingEnabled)
+	{
+		Utils::PrintToOutput(
+			"Meshlet bounds: frustum culling disabled, "
+			"only the Hi-Z is tested\n");
+	}
+
+	for (UINT scene = 0; scene < _countof(scenes); scene++)
+	{
+		Scene::CurrentScene = scenes[scene];
+		if (Scene::CurrentScene != currentScene)
+		{
+			// not updated while the scene is not shown
+			Scene::CurrentScene->camera.UpdateViewMatrix();
+			ShadowsResources::Shadows.Update();
+		}
+
+		_updateCullingViews();
+		CullingView views[Settings::MaxViewsCount];
+		for (UINT view = 0; view < _cullingViewsCount; view++)
+		{
+			views[view] = _cullingViews[view];
+			views[view].HiZCullingEnabled = 1;
+		}
+		_CPUCuller->Update(views, _cullingViewsCount);
+		_CPURasterizer->Update();
+
+		// builds the pyramids of the scene, with the tight AABBs
+		_CPURasterizer->SetHiZCulling(true);
+		_drawCPURasterizer();
+
+		const UINT instancesCount =
+			static_cast<UINT>(Scene::CurrentScene->instancesCPU.size());
+		for (UINT bounds = 0; bounds < _countof(boundsNames); bounds++)
+		{
+			_CPUCuller->SetSphereCubeBounds(bounds == 1);
+			for (UINT view = 0; view < _cullingViewsCount; view++)
+			{
+				_CPUCuller->SetHiZ(
+					view,
+					_CPURasterizer->GetHiZPyramid(view),
+					_CPURasterizer->GetHiZViewProjection(view));
+			}
+			_CPUCuller->Cull();
+
+			// the camera, then the cascades together
+			UINT frustumCulled[2] = {};
+			UINT HiZCulled[2] = {};
+			for (UINT view = 0; view < _cullingViewsCount; view++)
+			{
+				frustumCulled[view > 0] +=
+					_CPUCuller->GetFrustumCulledCount(view);
+				HiZCulled[view > 0] += _CPUCuller->GetHiZOccludedCount(view);
+				_CPUCuller->SetHiZ(
+					view,
+					nullptr,
+					_CPURasterizer->GetHiZViewProjection(view));
+			}
+
+			const float cameraInstances =
+				static_cast<float>(std::max(instancesCount, 1u));
+			const float cascadesInstances =
+				cameraInstances * (_cullingViewsCount - 1);
+			Utils::PrintToOutput(
+				"Meshlet bounds, %s, %s: camera %.2f%% frustum, "
+				"%.2f%% Hi-Z culled, cascades %.2f%% frustum, "
+				"%.2f%% Hi-Z culled of %u instances\n",
+				scenesNames[scene],
+				boundsNames[bounds],
+				100.0f * frustumCulled[0] / cameraInstances,
+				100.0f * HiZCulled[0] / cameraInstances,
+				100.0f * frustumCulled[1] / cascadesInstances,
+				100.0f * HiZCulled[1] / cascadesInstances,
+				instancesCount);
+		}
+	}
+
+	Scene::CurrentScene = currentScene;
+	Scene::CurrentScene->camera.UpdateViewMatrix();
+	ShadowsResources::Shadows.Update();
+	_updateCullingViews();
+	_CPUCuller->SetSphereCubeBounds(false);
+	_CPUCuller->Update(_cullingViews, _cullingViewsCount);
+	_CPURasterizer->Update();
+	_CPURasterizer->SetHiZCulling(HiZCullingEnabled);
+}
+
+// compares the CPU rasterizer output
+// against the GPU software rasterizer one
+void ForwardRenderer::_compareRasterizers()
+{
+	const float Tolerance = 0.01f;
+
+	_drawCPURasterizer();
+
+	std::vector<XMFLOAT4> GPUResult;
+	_SWR->GetRenderTargetReadback(GPUResult);
+	const auto& CPUResult = _CPURasterizer->GetRenderTarget();
+
+	UINT mismatchedPixels = 0;
+	float maxError = 0.0f;
+	for (size_t pixel = 0; pixel < CPUResult.size(); pixel++)
+	{
+		float error = XMVectorGetX(XMVector4Length(
+			XMLoadFloat4(&CPUResult[pixel]) -
+			XMLoadFloat4(&GPUResult[pixel])));
+		maxError = std::max(maxError, error);
+		mismatchedPixels += (error > Tolerance) ? 1 : 0;
+	}
+
+	Utils::PrintToOutput(
+		"CPU rasterizer: %.3f ms on %u workers with %s kernels, "
+		"%u / %u pipeline / rendered triangles (GPU: %u / %u)\n",
+		_CPURasterizer->GetRasterizationTimeMS(),
+		_CPURasterizer->GetWorkersCount(),
+		_CPURasterizer->GetKernelsName(),
+		_CPURasterizer->GetPipelineTrianglesCount(),
+		_CPURasterizer->GetRenderedTrianglesCount(),
+		_SWR->GetPipelineTrianglesCount(),
+		_SWR->GetRenderedTrianglesCount());
+	Utils::PrintToOutput(
+		"CPU rasterizer: %u vertices fetched, %u transformed%s%s\n",
+		_CPURasterizer->GetFetchedVerticesCount(),
+		_CPURasterizer->GetTransformedVerticesCount(),
+		_CPURasterizerMultiViewShadows ? ", multi-view shadows" : "",
+		_CPURasterizerVertexCache ? ", vertex cache" : "");
+	if (_CPURasterizerInFrameHiZ)
+	{
+		Utils::PrintToOutput(
+			"CPU rasterizer in-frame Hi-Z: %u triangle tiles "
+			"and %u meshlet tiles skipped%s\n",
+			_CPURasterizer->GetSkippedTileTrianglesCount(),
+			_CPURasterizer->GetSkippedTileMeshletsCount(),
+			_CPURasterizerFrontToBack ? ", front-to-back" : "");
+	}
+	if (_CPURasterizerTriangleCompaction)
+	{
+		Utils::PrintToOutput(
+			"CPU rasterizer compacted triangles: %u triangle tiles kept, "
+			"%u filtered, %.1f KB, filter %.3f ms, opaque %.3f ms\n",
+			_CPURasterizer->GetCompactedTrianglesCount(),
+			_CPURasterizer->GetFilteredTrianglesCount(),
+			_CPURasterizer->GetCompactedTrianglesBytes() / 1024.0f,
+			_CPURasterizer->GetFilterTimeMS(),
+			_CPURasterizer->GetOpaqueTimeMS());
+	}
+	Utils::PrintToOutput(
+		"CPU rasterizer rejected triangles: %u behind the camera, "
+		"%u back facing, %u off screen, %u between pixel centers, "
+		"%u occluded by Hi-Z\n",
+		_CPURasterizer->GetRejectedTrianglesCount(CPURasterizer::BehindCamera),
+		_CPURasterizer->GetRejectedTrianglesCount(CPURasterizer::BackFacing),
+		_CPURasterizer->GetRejectedTrianglesCount(CPURasterizer::OffScreen),
+		_CPURasterizer->GetRejectedTrianglesCount(
+			CPURasterizer::BetweenPixelCenters),
+		_CPURasterizer->GetRejectedTrianglesCount(
+			CPURasterizer::HiZOccluded));
+	Utils::PrintToOutput(
+		"CPU vs GPU: %.3f%% pixels differ by more than %.3f, "
+		"max error %.3f\n",
+		100.0f * mismatchedPixels / CPUResult.size(),
+		Tolerance,
+		maxError);
+}
+
+// the CPU rasterizer's depth and opaque passes
+// against its visibility buffer
+void ForwardRenderer::_compareCPURasterizerVisibilityBuffer()
+{
+	const float Tolerance = 0.01f;
+
+	bool visibilityBuffer = _CPURasterizer->IsVisibilityBuffer();
+
+	_CPURasterizer->SetVisibilityBuffer(false);
+	_drawCPURasterizer();
+	float twoPassesMS = _CPURasterizer->GetRasterizationTimeMS();
+	std::vector<XMFLOAT4> twoPassesResult = _CPURasterizer->GetRenderTarget();
+	std::vector<float> twoPassesDepth = _CPURasterizer->GetDepthBuffer();
+
+	_CPURasterizer->SetVisibilityBuffer(true);
+	_drawCPURasterizer();
+	const auto& visibilityBufferResult = _CPURasterizer->GetRenderTarget();
+
+	UINT mismatchedPixels = 0;
+	float maxError = 0.0f;
+	for (size_t pixel = 0; pixel < twoPassesResult.size(); pixel++)
+	{
+		float error = XMVectorGetX(XMVector4Length(
+			XMLoadFloat4(&visibilityBufferResult[pixel]) -
+			XMLoadFloat4(&twoPassesResult[pixel])));
+		maxError = std::max(maxError, error);
+		mismatchedPixels += (error > Tolerance) ? 1 : 0;
+	}
+
+	Utils::PrintToOutput(
+		"CPU rasterizer: %.3f ms with two passes, "
+		"%.3f ms with the visibility buffer, %s depth\n",
+		twoPassesMS,
+		_CPURasterizer->GetRasterizationTimeMS(),
+		(_CPURasterizer->GetDepthBuffer() == twoPassesDepth)
+			? "same"
+			: "different");
+	Utils::PrintToOutput(
+		"Two passes vs visibility buffer: %.3f%% pixels differ "
+		"by more than %.3f, max error %.3f\n",
+		100.0f * mismatchedPixels / twoPassesResult.size(),
+		Tolerance,
+		maxError);
+
+	_CPURasterizer->SetVisibilityBuffer(visibilityBuffer);
+}
+
+// a single section of buttons of the benchmarks and checks,
+// they log to the output
+void ForwardRenderer::_drawDiagnosticsGUI()
+{
+	if (!ImGui::CollapsingHeader("Diagnostics"))
+	{
+		return;
+	}
+
+	if (ImGui::Button("Profile CPU Culling"))
+	{
+		_profileCPUCulling();
+	}
+
+	if (ImGui::Button("Evaluate Hybrid Routing"))
+	{
+		_evaluateHybridRouting();
+	}
+
+	// the rest need the CPU rasterizer, which runs along the GPU one
+	if (!Settings::SWREnabled)
+	{
+		return;
+	}
+
+	if (ImGui::Button("Evaluate CPU Hi-Z Culling"))
+	{
+		_evaluateHiZCulling();
+	}
+
+	if (ImGui::Button("Evaluate Meshlet Bounds"))
+	{
+		_evaluateMeshletBounds();
+	}
+
+	if (ImGui::Button("Compare CPU and GPU Rasterizers"))
+	{
+		_compareRasterizersRequested = true;
+	}
+
+	if (ImGui::Button("Compare CPU Rasterizer Visibility Buffer"))
+	{
+		_compareCPURasterizerVisibilityBuffer();
+	}
+
+	if (ImGui::Button("Benchmark CPU Rasterizer Kernels"))
+	{
+		_CPURasterizerDiagnostics->BenchmarkKernels();
+	}
+
+	if (ImGui::Button("Check CPU Rasterizer Watertightness"))
+	{
+		_CPURasterizerDiagnostics->CheckWatertightness();
+	}
+
+	if (ImGui::Button("Check CPU Rasterizer Clipping"))
+	{
+		_CPURasterizerDiagnostics->CheckClipping();
+	}
+
+	if (ImGui::Button("Benchmark CPU Rasterizer Big Triangles"))
+	{
+		_CPURasterizerDiagnostics->BenchmarkBigTriangles();
+	}
+
+	// run after the next frame's Draw()
+	const char* frameBenchmarksLabels[] =
+	{
+		"Benchmark CPU Rasterizer Shadows",
+		"Benchmark CPU Rasterizer Front-To-Back",
+		"Benchmark CPU Rasterizer Triangle Compaction",
+		"Benchmark CPU Rasterizer Shading",
+		"Benchmark CPU Rasterizer Micro Triangles",
+		"Benchmark CPU Rasterizer Layouts",
+		"Benchmark CPU Hi-Z Pyramids"
+	};
+	static_assert(
+		_countof(frameBenchmarksLabels)
+			== CPURasterizerDiagnostics::FrameBenchmarksCount,
+		"a label per frame benchmark");
+
+	for (UINT benchmark = 0;
+		benchmark < CPURasterizerDiagnostics::FrameBenchmarksCount;
+		benchmark++)
+	{
+		if (ImGui::Button(frameBenchmarksLabels[benchmark]))
+		{
+			_CPURasterizerDiagnostics->Request(
+				static_cast<CPURasterizerDiagnostics::FrameBenchmarks>(
+					benchmark));
+		}
+	}
+}
\ No newline at end of file
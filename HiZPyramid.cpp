@@ -0,0 +1,433 @@
+#include "HiZPyramid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace
+{
+
+// [x0, x1) x [y0, y1) of output from the 2x2 texels above each one,
+// Max for the nearest depths instead of the farthest ones
+template <bool Max>
+void ReduceRect(
+	RasterizerKernels::HiZKernel kernel,
+	const float* input,
+	UINT inputWidth,
+	UINT inputHeight,
+	float* output,
+	UINT outputWidth,
+	UINT outputHeight,
+	UINT x0,
+	UINT x1,
+	UINT y0,
+	UINT y1)
+{
+	auto reduce = [](float a, float b)
+	{
+		return Max ? std::max(a, b) : std::min(a, b);
+	};
+
+	// a mip of 1 texel has no pair to take, its texel is taken as is
+	bool oddX = inputWidth > 1 && (inputWidth % 2) != 0;
+	bool oddY = inputHeight > 1 && (inputHeight % 2) != 0;
+	UINT pairsEnd = std::min(x1, inputWidth / 2);
+	for (UINT y = y0; y < y1; y++)
+	{
+		const float* row0 = input + 2 * y * inputWidth;
+		const float* row1 = (2 * y + 1 < inputHeight)
+			? row0 + inputWidth
+			: row0;
+		float* dst = output + y * outputWidth;
+		if (x0 < pairsEnd)
+		{
+			kernel(row0 + 2 * x0, row1 + 2 * x0, pairsEnd - x0, dst + x0);
+		}
+		for (UINT x = std::max(x0, pairsEnd); x < x1; x++)
+		{
+			dst[x] = reduce(row0[2 * x], row1[2 * x]);
+		}
+
+		if (oddX && x1 == outputWidth)
+		{
+			dst[x1 - 1] = reduce(
+				dst[x1 - 1],
+				reduce(row0[inputWidth - 1], row1[inputWidth - 1]));
+		}
+
+		if (oddY && y + 1 == outputHeight)
+		{
+			const float* row2 = row1 + inputWidth;
+			for (UINT x = x0; x < x1; x++)
+			{
+				dst[x] = reduce(dst[x], row2[2 * x]);
+				if (2 * x + 1 < inputWidth)
+				{
+					dst[x] = reduce(dst[x], row2[2 * x + 1]);
+				}
+			}
+			if (oddX && x1 == outputWidth)
+			{
+				dst[x1 - 1] = reduce(dst[x1 - 1], row2[inputWidth - 1]);
+			}
+		}
+	}
+}
+
+}
+
+void HiZPyramid::Build(
+	ThreadPool& threadPool,
+	const RasterizerKernels::Kernels& kernels,
+	const float* depth,
+	UINT width,
+	UINT height,
+	bool tiled)
+{
+	_resize(width, height);
+
+	UINT mipsCount = GetMipsCount();
+	// a row of it per band
+	UINT bandLevel = std::min(BandLevel, mipsCount - 1);
+	UINT bandsCount = _mips[bandLevel].height;
+	_remainingBands = bandsCount;
+
+	threadPool.ParallelFor(
+		bandsCount,
+		[&](UINT band, UINT)
+		{
+			// the last band also takes the rows past the bands,
+			// left by odd mips, so a band only reads the rows
+			// it wrote itself
+			auto bandRows = [&](UINT mip, UINT& y0, UINT& y1)
+			{
+				UINT shift = bandLevel - mip;
+				y0 = band << shift;
+				y1 = (band + 1 == bandsCount)
+					? _mips[mip].height
+					: (band + 1) << shift;
+			};
+
+			UINT y0, y1;
+			bandRows(0, y0, y1);
+			_copy(depth, tiled, y0, y1 - y0);
+			for (UINT mip = 1; mip <= bandLevel; mip++)
+			{
+				bandRows(mip, y0, y1);
+				_reduce(kernels, mip, 0, _mips[mip].width, y0, y1);
+			}
+
+			// the bands written by the others are visible to the last one
+			if (_remainingBands.fetch_sub(1) == 1)
+			{
+				for (UINT mip = bandLevel + 1; mip < mipsCount; mip++)
+				{
+					_reduce(
+						kernels,
+						mip,
+						0,
+						_mips[mip].width,
+						0,
+						_mips[mip].height);
+				}
+			}
+		});
+}
+
+void HiZPyramid::BuildPerMip(
+	ThreadPool& threadPool,
+	const RasterizerKernels::Kernels& kernels,
+	const float* depth,
+	UINT width,
+	UINT height,
+	bool tiled)
+{
+	_resize(width, height);
+
+	threadPool.ParallelFor(
+		height,
+		[&](UINT y, UINT)
+		{
+			_copy(depth, tiled, y, 1);
+		});
+	for (UINT mip = 1; mip < GetMipsCount(); mip++)
+	{
+		threadPool.ParallelFor(
+			_mips[mip].height,
+			[&](UINT y, UINT)
+			{
+				_reduce(kernels, mip, 0, _mips[mip].width, y, y + 1);
+			});
+	}
+}
+
+HiZPyramid::Results HiZPyramid::TestRect(
+	Tests test,
+	UINT minX,
+	UINT minY,
+	UINT maxX,
+	UINT maxY,
+	float nearestDepth,
+	float farthestDepth) const
+{
+	assert(maxX < _mips[0].width && maxY < _mips[0].height);
+
+	float minDepth = FLT_MAX;
+	float maxDepth = -FLT_MAX;
+	auto sample = [&](UINT mip, UINT x, UINT y)
+	{
+		size_t texel = static_cast<size_t>(y) * _mips[mip].width + x;
+		minDepth = std::min(minDepth, GetMinMip(mip)[texel]);
+		maxDepth = std::max(maxDepth, GetMaxMip(mip)[texel]);
+	};
+
+	// of CullingCS, a texel of it is half of the rect at least
+	UINT size = std::max(maxX - minX, maxY - minY) + 1;
+	UINT centerMip = static_cast<UINT>(std::max(
+		std::ceil(std::log2(0.5f * static_cast<float>(size))),
+		0.0f));
+	UINT topMip = GetMipsCount() - 1;
+
+	if (test == CenterTap)
+	{
+		// the texel centers around the rect's center in UV,
+		// as a bilinear min sampler picks them
+		UINT mip = std::min(centerMip, topMip);
+		const Mip& texels = _mips[mip];
+		float u = 0.5f * static_cast<float>(minX + maxX + 1)
+			/ static_cast<float>(_mips[0].width);
+		float v = 0.5f * static_cast<float>(minY + maxY + 1)
+			/ static_cast<float>(_mips[0].height);
+		INT x = static_cast<INT>(std::floor(u * texels.width - 0.5f));
+		INT y = static_cast<INT>(std::floor(v * texels.height - 0.5f));
+		for (INT tapY = y; tapY <= y + 1; tapY++)
+		{
+			for (INT tapX = x; tapX <= x + 1; tapX++)
+			{
+				sample(
+					mip,
+					std::clamp<INT>(tapX, 0, texels.width - 1),
+					std::clamp<INT>(tapY, 0, texels.height - 1));
+			}
+		}
+	}
+	else if (test == FootprintTaps)
+	{
+		// a texel x of a mip covers pixels [x << mip, (x + 1) << mip),
+		// the last one the rest of them
+		UINT mip = std::min(centerMip, topMip);
+		UINT x0, y0, x1, y1;
+		for (mip = (mip > 0) ? mip - 1 : 0; ; mip++)
+		{
+			const Mip& texels = _mips[mip];
+			x0 = std::min(minX >> mip, texels.width - 1);
+			y0 = std::min(minY >> mip, texels.height - 1);
+			x1 = std::min(maxX >> mip, texels.width - 1);
+			y1 = std::min(maxY >> mip, texels.height - 1);
+			if ((x1 - x0 <= 1 && y1 - y0 <= 1) || mip == topMip)
+			{
+				break;
+			}
+		}
+
+		for (UINT y = y0; y <= y1; y++)
+		{
+			for (UINT x = x0; x <= x1; x++)
+			{
+				sample(mip, x, y);
+			}
+		}
+	}
+	else
+	{
+		for (UINT y = minY; y <= maxY; y++)
+		{
+			for (UINT x = minX; x <= maxX; x++)
+			{
+				sample(0, x, y);
+			}
+		}
+	}
+
+	if (nearestDepth < minDepth)
+	{
+		return Occluded;
+	}
+
+	return (farthestDepth > maxDepth) ? InFront : Overlapping;
+}
+
+HiZPyramid::Results HiZPyramid::TestBox(
+	Tests test,
+	const AABB& boxWS,
+	const XMFLOAT4X4& VP) const
+{
+	XMMATRIX viewProjection = XMLoadFloat4x4(&VP);
+	XMVECTOR center = XMLoadFloat3(&boxWS.center);
+	XMVECTOR extents = XMLoadFloat3(&boxWS.extents);
+	XMFLOAT4 cornersCS[8];
+	for (UINT corner = 0; corner < 8; corner++)
+	{
+		XMVECTOR sign = XMVectorSet(
+			(corner & 1) ? 1.0f : -1.0f,
+			(corner & 2) ? 1.0f : -1.0f,
+			(corner & 4) ? 1.0f : -1.0f,
+			0.0f);
+		XMStoreFloat4(
+			&cornersCS[corner],
+			XMVector4Transform(
+				XMVectorSetW(center + extents * sign, 1.0f),
+				viewProjection));
+	}
+
+	return TestPoints(test, cornersCS, _countof(cornersCS));
+}
+
+HiZPyramid::Results HiZPyramid::TestPoints(
+	Tests test,
+	const XMFLOAT4* pointsCS,
+	UINT pointsCount) const
+{
+	XMVECTOR minP = XMVectorReplicate(FLT_MAX);
+	XMVECTOR maxP = XMVectorReplicate(-FLT_MAX);
+	for (UINT point = 0; point < pointsCount; point++)
+	{
+		XMVECTOR pointCS = XMLoadFloat4(&pointsCS[point]);
+		float w = XMVectorGetW(pointCS);
+		if (w <= 0.0f)
+		{
+			return Overlapping;
+		}
+
+		XMVECTOR pointNDC = pointCS / w;
+		minP = XMVectorMin(minP, pointNDC);
+		maxP = XMVectorMax(maxP, pointNDC);
+	}
+
+	XMFLOAT3 minNDC, maxNDC;
+	XMStoreFloat3(&minNDC, minP);
+	XMStoreFloat3(&maxNDC, maxP);
+
+	// NDC -> DX [0,1] -> SS, y flips
+	float width = static_cast<float>(_mips[0].width);
+	float height = static_cast<float>(_mips[0].height);
+	float minX = (minNDC.x * 0.5f + 0.5f) * width;
+	float maxX = (maxNDC.x * 0.5f + 0.5f) * width;
+	float minY = (maxNDC.y * -0.5f + 0.5f) * height;
+	float maxY = (minNDC.y * -0.5f + 0.5f) * height;
+	if (maxX < 0.0f || minX >= width || maxY < 0.0f || minY >= height)
+	{
+		return Overlapping;
+	}
+
+	auto toPixel = [](float p, float size)
+	{
+		return static_cast<UINT>(std::clamp(p, 0.0f, size - 1.0f));
+	};
+
+	return TestRect(
+		test,
+		toPixel(minX, width),
+		toPixel(minY, height),
+		toPixel(maxX, width),
+		toPixel(maxY, height),
+		maxNDC.z,
+		minNDC.z);
+}
+
+const char* HiZPyramid::GetTestName(Tests test)
+{
+	const char* names[TestsCount] =
+	{
+		"center tap",
+		"2x2 footprint",
+		"exact"
+	};
+
+	assert(test < TestsCount);
+	return names[test];
+}
+
+void HiZPyramid::_resize(UINT width, UINT height)
+{
+	_mips.clear();
+	_mips.push_back({ width, height, 0 });
+	_depth.resize(static_cast<size_t>(width) * height);
+
+	// down to 1 x 1, as Utils::MipsCount
+	size_t texelsCount = 0;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(width >> 1, 1u);
+		height = std::max(height >> 1, 1u);
+		_mips.push_back({ width, height, texelsCount });
+		texelsCount += static_cast<size_t>(width) * height;
+	}
+	_minTexels.resize(texelsCount);
+	_maxTexels.resize(texelsCount);
+}
+
+void HiZPyramid::_copy(
+	const float* depth,
+	bool tiled,
+	UINT firstRow,
+	UINT rowsCount)
+{
+	UINT width = _mips[0].width;
+	if (tiled)
+	{
+		RasterizerKernels::Detile(
+			depth,
+			width,
+			firstRow,
+			rowsCount,
+			_depth.data());
+	}
+	else
+	{
+		size_t offset = static_cast<size_t>(firstRow) * width;
+		memcpy(
+			_depth.data() + offset,
+			depth + offset,
+			sizeof(float) * width * rowsCount);
+	}
+}
+
+void HiZPyramid::_reduce(
+	const RasterizerKernels::Kernels& kernels,
+	UINT mip,
+	UINT x0,
+	UINT x1,
+	UINT y0,
+	UINT y1)
+{
+	const Mip& input = _mips[mip - 1];
+	const Mip& output = _mips[mip];
+	ReduceRect<false>(
+		kernels.hiZMin,
+		GetMinMip(mip - 1),
+		input.width,
+		input.height,
+		_minTexels.data() + output.offset,
+		output.width,
+		output.height,
+		x0,
+		x1,
+		y0,
+		y1);
+	ReduceRect<true>(
+		kernels.hiZMax,
+		GetMaxMip(mip - 1),
+		input.width,
+		input.height,
+		_maxTexels.data() + output.offset,
+		output.width,
+		output.height,
+		x0,
+		x1,
+		y0,
+		y1);
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Types.h"
+#include "ThreadPool.h"
+#include "RasterizerKernels.h"
+
+#include <atomic>
+#include <vector>
+
+// CPU Hi-Z of a reversed Z depth target, a texel of a mip keeps the min,
+// so the farthest depth, and the max, the nearest one, of the 2x2 texels
+// of the mip above, the last texel of a mip of an odd mip above also
+// covers its last row or column, as NPOTCorrection of GenerateHiZMipCS
+// does, so none is missed, mip 0 is a row-major copy of the target,
+// so the pyramid can be tested while the target is drawn again
+//
+// unlike Utils::GenerateHiZ, which dispatches a mip after another,
+// the whole chain is built in a single traversal, a task copies a band
+// of BandRows rows of the target and reduces it to a row of mip BandLevel,
+// writing every mip in between while the band is in cache, and the last
+// task to finish reduces the few mips left, bands span the whole width,
+// as tiles would walk rows a power of two apart, which share cache sets
+class HiZPyramid
+{
+public:
+
+	static const UINT BandLevel = 4;
+	static const UINT BandRows = 1 << BandLevel;
+
+	// texels a rect is tested against
+	enum Tests
+	{
+		// 2x2 texels around its center, bilinear, of the mip a texel of which
+		// is half of its longer side, as AABBVsHiZ of CullingCS,
+		// which may miss a part of it
+		CenterTap,
+		// at most 2x2 texels covering it, of the finest mip they cover it at,
+		// from a mip below the one of CenterTap
+		FootprintTaps,
+		// every pixel of it, for reference
+		ExactTaps,
+		TestsCount
+	};
+
+	enum Results
+	{
+		// behind the farthest depth of the texels
+		Occluded,
+		Overlapping,
+		// in front of the nearest depth of the texels
+		InFront,
+		ResultsCount
+	};
+
+	HiZPyramid() = default;
+	HiZPyramid(const HiZPyramid&) = delete;
+	HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+	// in parallel over bands, a tiled target
+	// is laid out as of RasterizerKernels::TiledOffset
+	void Build(
+		ThreadPool& threadPool,
+		const RasterizerKernels::Kernels& kernels,
+		const float* depth,
+		UINT width,
+		UINT height,
+		bool tiled = false);
+	// a mip after another, each in parallel over its rows,
+	// as GenerateHiZ does, the mips are the same as of Build()
+	void BuildPerMip(
+		ThreadPool& threadPool,
+		const RasterizerKernels::Kernels& kernels,
+		const float* depth,
+		UINT width,
+		UINT height,
+		bool tiled = false);
+
+	UINT GetMipsCount() const { return static_cast<UINT>(_mips.size()); }
+	UINT GetMipWidth(UINT mip) const { return _mips[mip].width; }
+	UINT GetMipHeight(UINT mip) const { return _mips[mip].height; }
+	// row-major, both are the copy of the target for mip 0
+	const float* GetMinMip(UINT mip) const
+	{
+		return (mip == 0)
+			? _depth.data()
+			: _minTexels.data() + _mips[mip].offset;
+	}
+	const float* GetMaxMip(UINT mip) const
+	{
+		return (mip == 0)
+			? _depth.data()
+			: _maxTexels.data() + _mips[mip].offset;
+	}
+
+	// [minX, maxX] x [minY, maxY] pixels of mip 0, within it,
+	// nearestDepth and farthestDepth of what covers them
+	Results TestRect(
+		Tests test,
+		UINT minX,
+		UINT minY,
+		UINT maxX,
+		UINT maxY,
+		float nearestDepth,
+		float farthestDepth) const;
+	// the WS box projected with VP, the one the target was drawn with,
+	// Overlapping if it crosses the near plane or misses the target
+	Results TestBox(
+		Tests test,
+		const AABB& boxWS,
+		const DirectX::XMFLOAT4X4& VP) const;
+	// the same for the hull of points in the clip space of that VP
+	Results TestPoints(
+		Tests test,
+		const DirectX::XMFLOAT4* pointsCS,
+		UINT pointsCount) const;
+
+	static const char* GetTestName(Tests test);
+
+private:
+
+	struct Mip
+	{
+		UINT width;
+		UINT height;
+		// into _minTexels and _maxTexels
+		size_t offset;
+	};
+
+	void _resize(UINT width, UINT height);
+	// rows [firstRow, firstRow + rowsCount) of mip 0
+	void _copy(
+		const float* depth,
+		bool tiled,
+		UINT firstRow,
+		UINT rowsCount);
+	// [x0, x1) x [y0, y1) of mip from the one above
+	void _reduce(
+		const RasterizerKernels::Kernels& kernels,
+		UINT mip,
+		UINT x0,
+		UINT x1,
+		UINT y0,
+		UINT y1);
+
+	std::vector<Mip> _mips;
+	std::vector<float> _depth;
+	// mips 1 and below
+	std::vector<float> _minTexels;
+	std::vector<float> _maxTexels;
+	// of the running Build()
+	std::atomic<UINT> _remainingBands = 0;
+};
\ No newline at end of file
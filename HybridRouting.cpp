@@ -0,0 +1,205 @@
+#include "HybridRouting.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+using namespace DirectX;
+
+namespace HybridRouting
+{
+
+namespace
+{
+
+// of the projected box, covered by a surface patch facing the view
+const float CoverageRatio = 0.5f;
+
+// shaded by the hardware rasterizer however small a triangle is
+const float QuadPixels = 4.0f;
+
+}
+
+MeshletEstimate Estimate(
+	const AABB& boxWS,
+	UINT trianglesCount,
+	const XMFLOAT4X4& VP,
+	const XMFLOAT2& resolution)
+{
+	MeshletEstimate result = {};
+	result.trianglesCount = trianglesCount;
+
+	XMMATRIX viewProjection = XMLoadFloat4x4(&VP);
+	XMVECTOR center = XMLoadFloat3(&boxWS.center);
+	XMVECTOR extents = XMLoadFloat3(&boxWS.extents);
+	XMVECTOR minP = XMVectorReplicate(1.0f);
+	XMVECTOR maxP = XMVectorReplicate(-1.0f);
+	for (UINT corner = 0; corner < 8; corner++)
+	{
+		XMVECTOR sign = XMVectorSet(
+			(corner & 1) ? 1.0f : -1.0f,
+			(corner & 2) ? 1.0f : -1.0f,
+			(corner & 4) ? 1.0f : -1.0f,
+			0.0f);
+		XMVECTOR cornerCS = XMVector4Transform(
+			XMVectorSetW(center + extents * sign, 1.0f),
+			viewProjection);
+		float w = XMVectorGetW(cornerCS);
+		if (w <= 0.0f)
+		{
+			result.crossesNearPlane = true;
+			break;
+		}
+
+		XMVECTOR cornerNDC = cornerCS / w;
+		minP = XMVectorMin(minP, cornerNDC);
+		maxP = XMVectorMax(maxP, cornerNDC);
+	}
+
+	// NDC of the whole screen otherwise
+	XMFLOAT2 size = { 2.0f, 2.0f };
+	if (!result.crossesNearPlane)
+	{
+		XMVECTOR one = XMVectorReplicate(1.0f);
+		XMStoreFloat2(
+			&size,
+			XMVectorClamp(maxP, -one, one) - XMVectorClamp(minP, -one, one));
+	}
+
+	float boxPixels =
+		0.25f * size.x * resolution.x * size.y * resolution.y;
+	result.trianglePixels =
+		CoverageRatio * boxPixels / std::max(trianglesCount, 1u);
+
+	return result;
+}
+
+float CostModel::GetSoftwareNS(float trianglePixels) const
+{
+	return softwareTriangleNS + softwarePixelNS * 2.0f * trianglePixels;
+}
+
+float CostModel::GetHardwareNS(float trianglePixels) const
+{
+	return hardwareTriangleNS
+		+ hardwarePixelNS * std::max(trianglePixels, QuadPixels);
+}
+
+float CostModel::GetCrossover() const
+{
+	// the software cost grows faster, so they meet at most once,
+	// below a quad the hardware one is constant
+	float slope = 2.0f * softwarePixelNS - hardwarePixelNS;
+	if (slope <= 0.0f)
+	{
+		return FLT_MAX;
+	}
+
+	float quadCrossover =
+		(GetHardwareNS(0.0f) - softwareTriangleNS) /
+		(2.0f * softwarePixelNS);
+	if (quadCrossover <= QuadPixels)
+	{
+		return std::max(quadCrossover, 0.0f);
+	}
+
+	return (hardwareTriangleNS - softwareTriangleNS) / slope;
+}
+
+std::vector<Prediction> Evaluate(
+	const std::vector<MeshletEstimate>& meshlets,
+	const CostModel& model)
+{
+	std::vector<float> thresholds = { 0.0f };
+	for (float threshold = 1.0f; threshold <= 1024.0f; threshold *= 2.0f)
+	{
+		thresholds.push_back(threshold);
+	}
+	thresholds.push_back(model.GetCrossover());
+	thresholds.push_back(FLT_MAX);
+	std::sort(thresholds.begin(), thresholds.end());
+
+	std::vector<Prediction> predictions;
+	for (float threshold : thresholds)
+	{
+		Prediction prediction = {};
+		prediction.threshold = threshold;
+
+		double nanoseconds = 0.0;
+		for (const MeshletEstimate& meshlet : meshlets)
+		{
+			Routes route = Route(meshlet, threshold);
+			float triangleNS = (route == SoftwareRoute)
+				? model.GetSoftwareNS(meshlet.trianglePixels)
+				: model.GetHardwareNS(meshlet.trianglePixels);
+			nanoseconds += static_cast<double>(triangleNS)
+				* meshlet.trianglesCount;
+			prediction.meshletsCount[route]++;
+			prediction.trianglesCount[route] += meshlet.trianglesCount;
+		}
+
+		prediction.frameMS = static_cast<float>(nanoseconds * 1e-6);
+		if (prediction.meshletsCount[SoftwareRoute] > 0
+			&& prediction.meshletsCount[HardwareRoute] > 0)
+		{
+			prediction.frameMS += model.hybridMS;
+		}
+
+		predictions.push_back(prediction);
+	}
+
+	return predictions;
+}
+
+void PrintEvaluation(
+	const char* sceneName,
+	const std::vector<Prediction>& predictions)
+{
+	auto best = std::min_element(
+		predictions.begin(),
+		predictions.end(),
+		[](const Prediction& a, const Prediction& b)
+		{
+			return a.frameMS < b.frameMS;
+		});
+
+	Utils::PrintToOutput(
+		"Hybrid routing of the %s scene, camera view:\n",
+		sceneName);
+	for (auto prediction = predictions.begin();
+		prediction != predictions.end();
+		prediction++)
+	{
+		char threshold[32];
+		if (prediction->threshold == FLT_MAX)
+		{
+			snprintf(threshold, sizeof(threshold), "software");
+		}
+		else if (prediction->threshold == 0.0f)
+		{
+			snprintf(threshold, sizeof(threshold), "hardware");
+		}
+		else
+		{
+			snprintf(
+				threshold,
+				sizeof(threshold),
+				"%.1f px",
+				prediction->threshold);
+		}
+
+		Utils::PrintToOutput(
+			"  %-10s %8.3f ms, software %6u meshlets %9llu triangles, "
+			"hardware %6u meshlets %9llu triangles%s\n",
+			threshold,
+			prediction->frameMS,
+			prediction->meshletsCount[SoftwareRoute],
+			prediction->trianglesCount[SoftwareRoute],
+			prediction->meshletsCount[HardwareRoute],
+			prediction->trianglesCount[HardwareRoute],
+			(prediction == best) ? ", best" : "");
+	}
+}
+
+}
\ No newline at end of file
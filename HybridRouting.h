@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+
+#include <vector>
+
+// splits the visible meshlets of a view between the software rasterizer,
+// which wins on small triangles, and the hardware one, which wins on big
+// ones, by the screen area per triangle estimated from their bounds
+namespace HybridRouting
+{
+
+enum Routes
+{
+	SoftwareRoute,
+	HardwareRoute,
+	RoutesCount
+};
+
+// of a visible meshlet instance
+struct MeshletEstimate
+{
+	// screen pixels per triangle
+	float trianglePixels;
+	UINT trianglesCount;
+	// the hardware rasterizer clips it,
+	// TriangleDepthCS would drop its triangles behind the camera
+	bool crossesNearPlane;
+};
+
+// its triangles are assumed to cover half of its WS box projected by VP
+// and clamped to the resolution, the whole of it if it crosses
+// the near plane
+MeshletEstimate Estimate(
+	const AABB& boxWS,
+	UINT trianglesCount,
+	const DirectX::XMFLOAT4X4& VP,
+	const DirectX::XMFLOAT2& resolution);
+
+// frame cost of a triangle of either rasterizer, linear in its pixels,
+// the defaults are rough figures of a desktop GPU, meant to be replaced
+// by ones fit to profiled frames of both paths
+struct CostModel
+{
+	// setup, and the pixels of its bounding box, which is about twice
+	// its area, walked by a single thread
+	float softwareTriangleNS = 1.0f;
+	float softwarePixelNS = 0.05f;
+	// setup, and its pixels, shaded in 2x2 quads, so at least one
+	float hardwareTriangleNS = 2.0f;
+	float hardwarePixelNS = 0.01f;
+	// both paths in a frame, e.g. merging their depths
+	float hybridMS = 0.1f;
+
+	float GetSoftwareNS(float trianglePixels) const;
+	float GetHardwareNS(float trianglePixels) const;
+	// pixels per triangle both paths cost the same at
+	float GetCrossover() const;
+};
+
+inline Routes Route(const MeshletEstimate& meshlet, float threshold)
+{
+	return (meshlet.trianglePixels < threshold && !meshlet.crossesNearPlane)
+		? SoftwareRoute
+		: HardwareRoute;
+}
+
+// of a frame routed by threshold
+struct Prediction
+{
+	float threshold;
+	float frameMS;
+	UINT meshletsCount[RoutesCount];
+	UINT64 trianglesCount[RoutesCount];
+};
+
+// offline, the frame cost of the meshlets for thresholds from 0,
+// all hardware, to FLT_MAX, all software but the ones crossing
+// the near plane, including the crossover one
+std::vector<Prediction> Evaluate(
+	const std::vector<MeshletEstimate>& meshlets,
+	const CostModel& model);
+// logs the predictions, the best one is marked
+void PrintEvaluation(
+	const char* sceneName,
+	const std::vector<Prediction>& predictions);
+
+}
\ No newline at end of file
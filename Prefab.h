@@ -1,10 +1,10 @@
-#pragma once
-
-#include "Types.h"
-
-struct Prefab
-{
-	UINT meshesOffset = 0;
-	UINT meshesCount = 0;
-	AABB AABB;
+#pragma once
+
+#include "Types.h"
+
+struct Prefab
+{
+	UINT meshesOffset = 0;
+	UINT meshesCount = 0;
+	AABB AABB;
 };
\ No newline at end of file
@@ -0,0 +1,1547 @@
+#include "RasterizerKernels.h"
+
+#include <algorithm>
+#include <immintrin.h>
+#include <intrin.h>
+
+namespace RasterizerKernels
+{
+
+namespace
+{
+
+// visits BlockSize x BlockSize blocks of [0, width) x [0, height)
+// skipping the ones trivially rejected, the whole rect is classified
+// first, so blocks of a rect completely inside aren't tested at all
+template <typename BlockFunc>
+void ForEachBlock(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	BlockFunc&& blockFunc)
+{
+	BlockCoverage rectCoverage = ClassifyBlock(t, 0, 0, width - 1, height - 1);
+	if (rectCoverage == Outside)
+	{
+		return;
+	}
+
+	for (UINT by = 0; by < height; by += BlockSize)
+	{
+		UINT ey = std::min(by + BlockSize, height);
+		for (UINT bx = 0; bx < width; bx += BlockSize)
+		{
+			UINT ex = std::min(bx + BlockSize, width);
+
+			BlockCoverage coverage = (rectCoverage == Inside)
+				? Inside
+				: ClassifyBlock(t, bx, by, ex - 1, ey - 1);
+			if (coverage != Outside)
+			{
+				blockFunc(bx, by, ex, ey, coverage == Inside);
+			}
+		}
+	}
+}
+
+// the same for the blocks of a tiled target overlapping
+// [originX, originX + width) x [originY, originY + height),
+// bx, by - of a block from the origin, negative for the first ones
+// if the origin is not aligned, [x0, ex) x [y0, ey) - its pixels
+// within the rect, block - its offset into the target
+template <typename BlockFunc>
+void ForEachTiledBlock(
+	const RasterTriangle& t,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	UINT blocksX,
+	BlockFunc&& blockFunc)
+{
+	BlockCoverage rectCoverage = ClassifyBlock(t, 0, 0, width - 1, height - 1);
+	if (rectCoverage == Outside)
+	{
+		return;
+	}
+
+	const INT Size = static_cast<INT>(BlockSize);
+	INT firstX = -static_cast<INT>(originX % BlockSize);
+	INT firstY = -static_cast<INT>(originY % BlockSize);
+	UINT rowBlock = TiledOffset(
+		originX - originX % BlockSize,
+		originY - originY % BlockSize,
+		blocksX);
+	for (INT by = firstY; by < static_cast<INT>(height); by += Size)
+	{
+		INT y0 = std::max(by, 0);
+		INT ey = std::min(by + Size, static_cast<INT>(height));
+		UINT block = rowBlock;
+		for (INT bx = firstX; bx < static_cast<INT>(width); bx += Size)
+		{
+			INT x0 = std::max(bx, 0);
+			INT ex = std::min(bx + Size, static_cast<INT>(width));
+
+			BlockCoverage coverage = (rectCoverage == Inside)
+				? Inside
+				: ClassifyBlock(t, x0, y0, ex - 1, ey - 1);
+			if (coverage != Outside)
+			{
+				blockFunc(bx, by, x0, y0, ex, ey, coverage == Inside, block);
+			}
+			block += BlockPixels;
+		}
+		rowBlock += blocksX * BlockPixels;
+	}
+}
+
+// scalar
+
+void DepthScalar(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch)
+{
+	ForEachBlock(
+		t,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			for (UINT y = by; y < ey; y++)
+			{
+				for (UINT x = bx; x < ex; x++)
+				{
+					if (inside || IsCovered(t, x, y))
+					{
+						float& dst = depth[y * pitch + x];
+						dst = std::max(
+							dst,
+							PlaneDepth(
+								t,
+								static_cast<float>(x),
+								static_cast<float>(y)));
+					}
+				}
+			}
+		});
+}
+
+void TiledDepthScalar(
+	const RasterTriangle& t,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX)
+{
+	ForEachTiledBlock(
+		t,
+		originX,
+		originY,
+		width,
+		height,
+		blocksX,
+		[&](INT bx, INT by, INT x0, INT y0, INT ex, INT ey,
+			bool inside, UINT block)
+		{
+			for (INT y = y0; y < ey; y++)
+			{
+				float* row = depth + block + (y - by) * BlockSize;
+				for (INT x = x0; x < ex; x++)
+				{
+					if (inside || IsCovered(t, x, y))
+					{
+						float& dst = row[x - bx];
+						dst = std::max(
+							dst,
+							PlaneDepth(
+								t,
+								static_cast<float>(x),
+								static_cast<float>(y)));
+					}
+				}
+			}
+		});
+}
+
+UINT VisibilityScalar(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels)
+{
+	UINT count = 0;
+	ForEachBlock(
+		t,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			for (UINT y = by; y < ey; y++)
+			{
+				for (UINT x = bx; x < ex; x++)
+				{
+					if (inside || IsCovered(t, x, y))
+					{
+						if (depth[y * pitch + x] == PlaneDepth(
+							t,
+							static_cast<float>(x),
+							static_cast<float>(y)))
+						{
+							visiblePixels[count++] = x | (y << 16);
+						}
+					}
+				}
+			}
+		});
+
+	return count;
+}
+
+// signed, see VisibilityBufferKernel
+void MaxVisibility(UINT64& dst, UINT64 value)
+{
+	if (static_cast<INT64>(value) > static_cast<INT64>(dst))
+	{
+		dst = value;
+	}
+}
+
+void VisibilityBufferScalar(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch)
+{
+	ForEachBlock(
+		t,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			for (UINT y = by; y < ey; y++)
+			{
+				for (UINT x = bx; x < ex; x++)
+				{
+					if (inside || IsCovered(t, x, y))
+					{
+						MaxVisibility(
+							visibility[y * pitch + x],
+							PackVisibility(
+								PlaneDepth(
+									t,
+									static_cast<float>(x),
+									static_cast<float>(y)),
+								id));
+					}
+				}
+			}
+		});
+}
+
+// a triangle per iteration, the same math as SetupTileRaster
+// and PlaneDepth, at the origin of the first pixel center
+void DepthMicroScalar(
+	const MicroTriangles& t,
+	float* depth,
+	UINT pitch)
+{
+	for (UINT lane = 0; lane < t.count; lane++)
+	{
+		const INT xs[3] = { t.x0[lane], t.x1[lane], t.x2[lane] };
+		const INT ys[3] = { t.y0[lane], t.y1[lane], t.y2[lane] };
+		INT edges[3], edgesDx[3], edgesDy[3];
+		for (UINT edge = 0; edge < 3; edge++)
+		{
+			// from the vertex after the one opposite to the edge
+			UINT a = (edge + 1) % 3;
+			UINT b = (edge + 2) % 3;
+			INT ex = xs[b] - xs[a];
+			INT ey = ys[b] - ys[a];
+			edges[edge] = ex * -ys[a] + xs[a] * ey;
+			bool topLeft = ey < 0 || (ey == 0 && ex > 0);
+			edges[edge] -= topLeft ? 0 : 1;
+			edgesDx[edge] = ex * SubpixelScale;
+			edgesDy[edge] = ey * SubpixelScale;
+		}
+
+		float e0x = t.p2x[lane] - t.p1x[lane];
+		float e0y = t.p2y[lane] - t.p1y[lane];
+		float area0 = e0x * (t.originY[lane] - t.p1y[lane])
+			- (t.originX[lane] - t.p1x[lane]) * e0y;
+		float e1x = t.p0x[lane] - t.p2x[lane];
+		float e1y = t.p0y[lane] - t.p2y[lane];
+		float area1 = e1x * (t.originY[lane] - t.p2y[lane])
+			- (t.originX[lane] - t.p2x[lane]) * e1y;
+		float z02 = (t.z0[lane] - t.z2[lane]) * t.invArea[lane];
+		float z12 = (t.z1[lane] - t.z2[lane]) * t.invArea[lane];
+		float planeDepth = t.z2[lane] + area0 * z02 + area1 * z12;
+		float depthDx = -(e0y * z02 + e1y * z12);
+		float depthDy = e0x * z02 + e1x * z12;
+
+		for (INT y = 0; y < t.height[lane]; y++)
+		{
+			for (INT x = 0; x < t.width[lane]; x++)
+			{
+				// sign bit is set if any of them is negative
+				INT outside = 0;
+				for (UINT edge = 0; edge < 3; edge++)
+				{
+					outside |=
+						edges[edge] - x * edgesDy[edge] + y * edgesDx[edge];
+				}
+				if (outside < 0)
+				{
+					continue;
+				}
+
+				float& dst = depth[t.offset[lane] + y * pitch + x];
+				dst = std::max(
+					dst,
+					planeDepth
+						+ static_cast<float>(x) * depthDx
+						+ static_cast<float>(y) * depthDy);
+			}
+		}
+	}
+}
+
+// Max for the nearest depth instead of the farthest one
+template <bool Max>
+void HiZScalar(
+	const float* row0,
+	const float* row1,
+	UINT count,
+	float* output)
+{
+	auto reduce = [](float a, float b)
+	{
+		return Max ? std::max(a, b) : std::min(a, b);
+	};
+
+	for (UINT x = 0; x < count; x++)
+	{
+		output[x] = reduce(
+			reduce(row0[2 * x], row0[2 * x + 1]),
+			reduce(row1[2 * x], row1[2 * x + 1]));
+	}
+}
+
+// AVX2, 8x1 pixels
+// the same operations in the same order as the scalar path,
+// no FMAs, so the results are bit exact
+
+struct TriangleAVX2
+{
+	__m256 depth, depthDx, depthDy;
+	// fixed point edge function offsets of lanes 0-3 and 4-7
+	__m256i laneEdges0[2], laneEdges1[2], laneEdges2[2];
+};
+
+void LaneEdgesAVX2(INT64 edgeDy, __m256i laneEdges[2])
+{
+	laneEdges[0] = _mm256_setr_epi64x(0, -edgeDy, -2 * edgeDy, -3 * edgeDy);
+	laneEdges[1] = _mm256_add_epi64(
+		laneEdges[0],
+		_mm256_set1_epi64x(-4 * edgeDy));
+}
+
+TriangleAVX2 LoadAVX2(const RasterTriangle& t)
+{
+	TriangleAVX2 result;
+	LaneEdgesAVX2(t.edgeDy0, result.laneEdges0);
+	LaneEdgesAVX2(t.edgeDy1, result.laneEdges1);
+	LaneEdgesAVX2(t.edgeDy2, result.laneEdges2);
+	result.depth = _mm256_set1_ps(t.depth);
+	result.depthDx = _mm256_set1_ps(t.depthDx);
+	result.depthDy = _mm256_set1_ps(t.depthDy);
+
+	return result;
+}
+
+// sign bits are set for the pixels (x + lane, y) outside of the triangle,
+// there is no 64 bit multiply in AVX2, so the row start is scalar
+__m256 OutsideAVX2(
+	const RasterTriangle& triangle,
+	const TriangleAVX2& t,
+	INT x,
+	INT y)
+{
+	INT64 edge0, edge1, edge2;
+	FixedPointEdgeFunctions(triangle, x, y, edge0, edge1, edge2);
+	__m256i rowEdge0 = _mm256_set1_epi64x(edge0);
+	__m256i rowEdge1 = _mm256_set1_epi64x(edge1);
+	__m256i rowEdge2 = _mm256_set1_epi64x(edge2);
+
+	// any of them is negative if their or is
+	__m256i halves[2];
+	for (UINT half = 0; half < 2; half++)
+	{
+		halves[half] = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_add_epi64(rowEdge0, t.laneEdges0[half]),
+				_mm256_add_epi64(rowEdge1, t.laneEdges1[half])),
+			_mm256_add_epi64(rowEdge2, t.laneEdges2[half]));
+	}
+
+	// high words hold the signs, they come out as lanes 0 1 4 5 2 3 6 7
+	__m256 signs = _mm256_shuffle_ps(
+		_mm256_castsi256_ps(halves[0]),
+		_mm256_castsi256_ps(halves[1]),
+		_MM_SHUFFLE(3, 1, 3, 1));
+
+	return _mm256_castpd_ps(_mm256_permute4x64_pd(
+		_mm256_castps_pd(signs),
+		_MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// returns depth, coverage is and-ed into sign bits of mask
+__m256 ShadeAVX2(
+	const RasterTriangle& triangle,
+	const TriangleAVX2& t,
+	INT bx,
+	__m256 x,
+	INT y,
+	bool inside,
+	__m256& mask)
+{
+	if (!inside)
+	{
+		mask = _mm256_andnot_ps(OutsideAVX2(triangle, t, bx, y), mask);
+	}
+
+	return _mm256_add_ps(
+		_mm256_add_ps(t.depth, _mm256_mul_ps(x, t.depthDx)),
+		_mm256_mul_ps(_mm256_set1_ps(static_cast<float>(y)), t.depthDy));
+}
+
+void DepthAVX2(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch)
+{
+	TriangleAVX2 t = LoadAVX2(triangle);
+	const __m256 laneX = _mm256_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m256 x = _mm256_add_ps(
+				_mm256_set1_ps(static_cast<float>(bx)),
+				laneX);
+			// partial blocks at the right border
+			__m256 rowMask = _mm256_cmp_ps(
+				laneX,
+				_mm256_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y++)
+			{
+				__m256 mask = rowMask;
+				__m256 pixelDepth = ShadeAVX2(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					inside,
+					mask);
+
+				float* row = depth + y * pitch + bx;
+				__m256 stored = _mm256_maskload_ps(
+					row,
+					_mm256_castps_si256(rowMask));
+				_mm256_maskstore_ps(
+					row,
+					_mm256_castps_si256(mask),
+					_mm256_max_ps(stored, pixelDepth));
+			}
+		});
+}
+
+// a row of a block is a single masked load and store
+void TiledDepthAVX2(
+	const RasterTriangle& triangle,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX)
+{
+	TriangleAVX2 t = LoadAVX2(triangle);
+	const __m256 laneX = _mm256_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+	ForEachTiledBlock(
+		triangle,
+		originX,
+		originY,
+		width,
+		height,
+		blocksX,
+		[&](INT bx, INT by, INT x0, INT y0, INT ex, INT ey,
+			bool inside, UINT block)
+		{
+			__m256 x = _mm256_add_ps(
+				_mm256_set1_ps(static_cast<float>(bx)),
+				laneX);
+			// pixels of the block out of the rect
+			__m256 rowMask = _mm256_and_ps(
+				_mm256_cmp_ps(
+					laneX,
+					_mm256_set1_ps(static_cast<float>(x0 - bx)),
+					_CMP_GE_OQ),
+				_mm256_cmp_ps(
+					laneX,
+					_mm256_set1_ps(static_cast<float>(ex - bx)),
+					_CMP_LT_OQ));
+
+			for (INT y = y0; y < ey; y++)
+			{
+				__m256 mask = rowMask;
+				__m256 pixelDepth = ShadeAVX2(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					inside,
+					mask);
+
+				float* row = depth + block + (y - by) * BlockSize;
+				__m256 stored = _mm256_maskload_ps(
+					row,
+					_mm256_castps_si256(rowMask));
+				_mm256_maskstore_ps(
+					row,
+					_mm256_castps_si256(mask),
+					_mm256_max_ps(stored, pixelDepth));
+			}
+		});
+}
+
+UINT VisibilityAVX2(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels)
+{
+	TriangleAVX2 t = LoadAVX2(triangle);
+	const __m256 laneX = _mm256_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+	UINT count = 0;
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m256 x = _mm256_add_ps(
+				_mm256_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__m256 rowMask = _mm256_cmp_ps(
+				laneX,
+				_mm256_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y++)
+			{
+				__m256 mask = rowMask;
+				__m256 pixelDepth = ShadeAVX2(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					inside,
+					mask);
+
+				__m256 stored = _mm256_maskload_ps(
+					depth + y * pitch + bx,
+					_mm256_castps_si256(rowMask));
+				mask = _mm256_and_ps(
+					mask,
+					_mm256_cmp_ps(stored, pixelDepth, _CMP_EQ_OQ));
+
+				unsigned long lane;
+				UINT bits = static_cast<UINT>(_mm256_movemask_ps(mask));
+				while (_BitScanForward(&lane, bits))
+				{
+					visiblePixels[count++] = (bx + lane) | (y << 16);
+					bits &= bits - 1;
+				}
+			}
+		});
+
+	return count;
+}
+
+// FixedPointEdgeFunction of a lane at the origin
+void MicroEdgeAVX2(
+	__m256i ax,
+	__m256i ay,
+	__m256i bx,
+	__m256i by,
+	__m256i& edge,
+	__m256i& edgeDx,
+	__m256i& edgeDy)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i ex = _mm256_sub_epi32(bx, ax);
+	__m256i ey = _mm256_sub_epi32(by, ay);
+	edge = _mm256_add_epi32(
+		_mm256_mullo_epi32(ex, _mm256_sub_epi32(zero, ay)),
+		_mm256_mullo_epi32(ax, ey));
+
+	// all bits are set for the edges that are not top-left, so -1
+	__m256i topLeft = _mm256_or_si256(
+		_mm256_cmpgt_epi32(zero, ey),
+		_mm256_and_si256(
+			_mm256_cmpeq_epi32(ey, zero),
+			_mm256_cmpgt_epi32(ex, zero)));
+	edge = _mm256_add_epi32(
+		edge,
+		_mm256_andnot_si256(topLeft, _mm256_set1_epi32(-1)));
+
+	edgeDx = _mm256_slli_epi32(ex, SubpixelBits);
+	edgeDy = _mm256_slli_epi32(ey, SubpixelBits);
+}
+
+// a triangle per lane, the same operations in the same order
+// as the scalar path, the up to 4 pixel centers are tested
+// for all lanes at once and written per lane
+void DepthMicroAVX2(
+	const MicroTriangles& t,
+	float* depth,
+	UINT pitch)
+{
+	auto loadInt = [](const INT* values)
+	{
+		return _mm256_load_si256(reinterpret_cast<const __m256i*>(values));
+	};
+
+	__m256i edges[3], edgesDx[3], edgesDy[3];
+	MicroEdgeAVX2(
+		loadInt(t.x1), loadInt(t.y1),
+		loadInt(t.x2), loadInt(t.y2),
+		edges[0], edgesDx[0], edgesDy[0]);
+	MicroEdgeAVX2(
+		loadInt(t.x2), loadInt(t.y2),
+		loadInt(t.x0), loadInt(t.y0),
+		edges[1], edgesDx[1], edgesDy[1]);
+	MicroEdgeAVX2(
+		loadInt(t.x0), loadInt(t.y0),
+		loadInt(t.x1), loadInt(t.y1),
+		edges[2], edgesDx[2], edgesDy[2]);
+
+	__m256 p0x = _mm256_load_ps(t.p0x);
+	__m256 p0y = _mm256_load_ps(t.p0y);
+	__m256 p1x = _mm256_load_ps(t.p1x);
+	__m256 p1y = _mm256_load_ps(t.p1y);
+	__m256 p2x = _mm256_load_ps(t.p2x);
+	__m256 p2y = _mm256_load_ps(t.p2y);
+	__m256 originX = _mm256_load_ps(t.originX);
+	__m256 originY = _mm256_load_ps(t.originY);
+	__m256 invArea = _mm256_load_ps(t.invArea);
+	__m256 z2 = _mm256_load_ps(t.z2);
+
+	__m256 e0x = _mm256_sub_ps(p2x, p1x);
+	__m256 e0y = _mm256_sub_ps(p2y, p1y);
+	__m256 area0 = _mm256_sub_ps(
+		_mm256_mul_ps(e0x, _mm256_sub_ps(originY, p1y)),
+		_mm256_mul_ps(_mm256_sub_ps(originX, p1x), e0y));
+	__m256 e1x = _mm256_sub_ps(p0x, p2x);
+	__m256 e1y = _mm256_sub_ps(p0y, p2y);
+	__m256 area1 = _mm256_sub_ps(
+		_mm256_mul_ps(e1x, _mm256_sub_ps(originY, p2y)),
+		_mm256_mul_ps(_mm256_sub_ps(originX, p2x), e1y));
+	__m256 z02 = _mm256_mul_ps(
+		_mm256_sub_ps(_mm256_load_ps(t.z0), z2),
+		invArea);
+	__m256 z12 = _mm256_mul_ps(
+		_mm256_sub_ps(_mm256_load_ps(t.z1), z2),
+		invArea);
+	__m256 planeDepth = _mm256_add_ps(
+		_mm256_add_ps(z2, _mm256_mul_ps(area0, z02)),
+		_mm256_mul_ps(area1, z12));
+	__m256 depthDx = _mm256_xor_ps(
+		_mm256_set1_ps(-0.0f),
+		_mm256_add_ps(_mm256_mul_ps(e0y, z02), _mm256_mul_ps(e1y, z12)));
+	__m256 depthDy = _mm256_add_ps(
+		_mm256_mul_ps(e0x, z02),
+		_mm256_mul_ps(e1x, z12));
+
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i lanes = _mm256_cmpgt_epi32(
+		_mm256_set1_epi32(static_cast<INT>(t.count)),
+		_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	__m256i width = loadInt(t.width);
+	__m256i height = loadInt(t.height);
+
+	alignas(32) float pixelDepths[MicroBatchSize];
+	for (INT y = 0; y < 2; y++)
+	{
+		for (INT x = 0; x < 2; x++)
+		{
+			__m256i mask = _mm256_and_si256(
+				lanes,
+				_mm256_and_si256(
+					_mm256_cmpgt_epi32(width, _mm256_set1_epi32(x)),
+					_mm256_cmpgt_epi32(height, _mm256_set1_epi32(y))));
+
+			// any of them is negative if their or is
+			__m256i outside = zero;
+			for (UINT edge = 0; edge < 3; edge++)
+			{
+				__m256i value = edges[edge];
+				value = x ? _mm256_sub_epi32(value, edgesDy[edge]) : value;
+				value = y ? _mm256_add_epi32(value, edgesDx[edge]) : value;
+				outside = _mm256_or_si256(outside, value);
+			}
+			mask = _mm256_andnot_si256(
+				_mm256_cmpgt_epi32(zero, outside),
+				mask);
+
+			unsigned long lane;
+			UINT bits = static_cast<UINT>(
+				_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+			if (bits == 0)
+			{
+				continue;
+			}
+
+			_mm256_store_ps(
+				pixelDepths,
+				_mm256_add_ps(
+					_mm256_add_ps(
+						planeDepth,
+						_mm256_mul_ps(
+							_mm256_set1_ps(static_cast<float>(x)),
+							depthDx)),
+					_mm256_mul_ps(
+						_mm256_set1_ps(static_cast<float>(y)),
+						depthDy)));
+			while (_BitScanForward(&lane, bits))
+			{
+				float& dst = depth[t.offset[lane] + y * pitch + x];
+				dst = std::max(dst, pixelDepths[lane]);
+				bits &= bits - 1;
+			}
+		}
+	}
+}
+
+// 64 bit lanes, so a row is written as two halves of 4 pixels
+void VisibilityBufferAVX2(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch)
+{
+	TriangleAVX2 t = LoadAVX2(triangle);
+	const __m256 laneX = _mm256_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256i ids = _mm256_set1_epi64x(id);
+
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m256 x = _mm256_add_ps(
+				_mm256_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__m256 rowMask = _mm256_cmp_ps(
+				laneX,
+				_mm256_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y++)
+			{
+				__m256 mask = rowMask;
+				__m256 pixelDepth = ShadeAVX2(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					inside,
+					mask);
+
+				__m128 halvesDepth[2] =
+				{
+					_mm256_castps256_ps128(pixelDepth),
+					_mm256_extractf128_ps(pixelDepth, 1)
+				};
+				__m128 halvesMask[2] =
+				{
+					_mm256_castps256_ps128(mask),
+					_mm256_extractf128_ps(mask, 1)
+				};
+				__m128 halvesRowMask[2] =
+				{
+					_mm256_castps256_ps128(rowMask),
+					_mm256_extractf128_ps(rowMask, 1)
+				};
+				for (UINT half = 0; half < 2; half++)
+				{
+					auto* row = reinterpret_cast<long long*>(
+						visibility + y * pitch + bx + 4 * half);
+
+					// sign extended, so are the sign bits
+					__m256i halfMask = _mm256_cvtepi32_epi64(
+						_mm_castps_si128(halvesMask[half]));
+					__m256i halfRowMask = _mm256_cvtepi32_epi64(
+						_mm_castps_si128(halvesRowMask[half]));
+
+					// see PackVisibility
+					__m256i value = _mm256_or_si256(
+						_mm256_slli_epi64(
+							_mm256_cvtepu32_epi64(
+								_mm_castps_si128(halvesDepth[half])),
+							32),
+						ids);
+					__m256i stored = _mm256_maskload_epi64(row, halfRowMask);
+					_mm256_maskstore_epi64(
+						row,
+						_mm256_and_si256(
+							halfMask,
+							_mm256_cmpgt_epi64(value, stored)),
+						value);
+				}
+			}
+		});
+}
+
+// 8 outputs of 16 pixels of both rows, the rows first, then pairs,
+// picked within 128 bit lanes, so the halves are swapped back after
+template <bool Max>
+void HiZAVX2(
+	const float* row0,
+	const float* row1,
+	UINT count,
+	float* output)
+{
+	auto reduce = [](__m256 a, __m256 b)
+	{
+		return Max ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+	};
+
+	UINT x = 0;
+	for (; x + 8 <= count; x += 8)
+	{
+		__m256 low = reduce(
+			_mm256_loadu_ps(row0 + 2 * x),
+			_mm256_loadu_ps(row1 + 2 * x));
+		__m256 high = reduce(
+			_mm256_loadu_ps(row0 + 2 * x + 8),
+			_mm256_loadu_ps(row1 + 2 * x + 8));
+		__m256 pairs = reduce(
+			_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)),
+			_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+		_mm256_storeu_ps(
+			output + x,
+			_mm256_castpd_ps(_mm256_permute4x64_pd(
+				_mm256_castps_pd(pairs),
+				_MM_SHUFFLE(3, 1, 2, 0))));
+	}
+
+	HiZScalar<Max>(row0 + 2 * x, row1 + 2 * x, count - x, output + x);
+}
+
+// AVX-512, 8x2 pixels, two rows of a block per instruction
+
+struct TriangleAVX512
+{
+	__m512 depth, depthDx, depthDy;
+	// fixed point edge function offsets of lanes 0-7 of a row
+	__m512i laneEdges0, laneEdges1, laneEdges2;
+};
+
+__m512i LaneEdgesAVX512(INT64 edgeDy)
+{
+	return _mm512_setr_epi64(
+		0, -edgeDy, -2 * edgeDy, -3 * edgeDy,
+		-4 * edgeDy, -5 * edgeDy, -6 * edgeDy, -7 * edgeDy);
+}
+
+TriangleAVX512 LoadAVX512(const RasterTriangle& t)
+{
+	TriangleAVX512 result;
+	result.laneEdges0 = LaneEdgesAVX512(t.edgeDy0);
+	result.laneEdges1 = LaneEdgesAVX512(t.edgeDy1);
+	result.laneEdges2 = LaneEdgesAVX512(t.edgeDy2);
+	result.depth = _mm512_set1_ps(t.depth);
+	result.depthDx = _mm512_set1_ps(t.depthDx);
+	result.depthDy = _mm512_set1_ps(t.depthDy);
+
+	return result;
+}
+
+// bits are set for the pixels of a row outside of the triangle
+__mmask8 RowOutsideAVX512(
+	const TriangleAVX512& t,
+	INT64 edge0,
+	INT64 edge1,
+	INT64 edge2)
+{
+	// any of them is negative if their or is
+	__m512i edges = _mm512_or_epi64(
+		_mm512_or_epi64(
+			_mm512_add_epi64(_mm512_set1_epi64(edge0), t.laneEdges0),
+			_mm512_add_epi64(_mm512_set1_epi64(edge1), t.laneEdges1)),
+		_mm512_add_epi64(_mm512_set1_epi64(edge2), t.laneEdges2));
+
+	return _mm512_cmplt_epi64_mask(edges, _mm512_setzero_si512());
+}
+
+// bits are set for the pixels (x + lane % 8, y + lane / 8) outside
+// of the triangle
+__mmask16 OutsideAVX512(
+	const RasterTriangle& triangle,
+	const TriangleAVX512& t,
+	INT x,
+	INT y)
+{
+	INT64 edge0, edge1, edge2;
+	FixedPointEdgeFunctions(triangle, x, y, edge0, edge1, edge2);
+
+	__mmask8 row0 = RowOutsideAVX512(t, edge0, edge1, edge2);
+	__mmask8 row1 = RowOutsideAVX512(
+		t,
+		edge0 + triangle.edgeDx0,
+		edge1 + triangle.edgeDx1,
+		edge2 + triangle.edgeDx2);
+
+	return static_cast<__mmask16>(row0 | (row1 << 8));
+}
+
+__m512 ShadeAVX512(
+	const RasterTriangle& triangle,
+	const TriangleAVX512& t,
+	INT bx,
+	__m512 x,
+	INT y,
+	__m512 laneY,
+	bool inside,
+	__mmask16& mask)
+{
+	if (!inside)
+	{
+		mask &= ~OutsideAVX512(triangle, t, bx, y);
+	}
+
+	__m512 yf = _mm512_add_ps(
+		_mm512_set1_ps(static_cast<float>(y)),
+		laneY);
+
+	return _mm512_add_ps(
+		_mm512_add_ps(t.depth, _mm512_mul_ps(x, t.depthDx)),
+		_mm512_mul_ps(yf, t.depthDy));
+}
+
+// rows are not adjacent in memory, so they are moved as 8 wide halves
+void HalfMasksAVX512(__mmask16 mask, __m256i& lo, __m256i& hi)
+{
+	__m512i lanes = _mm512_maskz_mov_epi32(mask, _mm512_set1_epi32(-1));
+	lo = _mm512_castsi512_si256(lanes);
+	hi = _mm512_extracti64x4_epi64(lanes, 1);
+}
+
+__m512 LoadRowsAVX512(
+	const float* row0,
+	const float* row1,
+	__mmask16 mask)
+{
+	__m256i maskLo, maskHi;
+	HalfMasksAVX512(mask, maskLo, maskHi);
+	__m256 lo = _mm256_maskload_ps(row0, maskLo);
+	__m256 hi = _mm256_maskload_ps(row1, maskHi);
+
+	return _mm512_castpd_ps(_mm512_insertf64x4(
+		_mm512_castps_pd(_mm512_castps256_ps512(lo)),
+		_mm256_castps_pd(hi),
+		1));
+}
+
+void StoreRowsAVX512(
+	float* row0,
+	float* row1,
+	__mmask16 mask,
+	__m512 value)
+{
+	__m256i maskLo, maskHi;
+	HalfMasksAVX512(mask, maskLo, maskHi);
+	_mm256_maskstore_ps(row0, maskLo, _mm512_castps512_ps256(value));
+	_mm256_maskstore_ps(
+		row1,
+		maskHi,
+		_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(value), 1)));
+}
+
+void DepthAVX512(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch)
+{
+	TriangleAVX512 t = LoadAVX512(triangle);
+	const __m512 laneX = _mm512_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m512 laneY = _mm512_setr_ps(
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m512 x = _mm512_add_ps(
+				_mm512_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__mmask16 columnsMask = _mm512_cmp_ps_mask(
+				laneX,
+				_mm512_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y += 2)
+			{
+				bool secondRow = y + 1 < ey;
+				__mmask16 rowsMask = secondRow
+					? columnsMask
+					: static_cast<__mmask16>(columnsMask & 0x00FF);
+
+				__mmask16 mask = rowsMask;
+				__m512 pixelDepth = ShadeAVX512(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					laneY,
+					inside,
+					mask);
+
+				float* row0 = depth + y * pitch + bx;
+				float* row1 = secondRow ? row0 + pitch : row0;
+				__m512 stored = LoadRowsAVX512(row0, row1, rowsMask);
+				StoreRowsAVX512(
+					row0,
+					row1,
+					mask,
+					_mm512_max_ps(stored, pixelDepth));
+			}
+		});
+}
+
+// two rows of a block are adjacent, so they are a single
+// masked load and store
+void TiledDepthAVX512(
+	const RasterTriangle& triangle,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX)
+{
+	TriangleAVX512 t = LoadAVX512(triangle);
+	const __m512 laneX = _mm512_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m512 laneY = _mm512_setr_ps(
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+
+	ForEachTiledBlock(
+		triangle,
+		originX,
+		originY,
+		width,
+		height,
+		blocksX,
+		[&](INT bx, INT by, INT x0, INT y0, INT ex, INT ey,
+			bool inside, UINT block)
+		{
+			__m512 x = _mm512_add_ps(
+				_mm512_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__mmask16 columnsMask = _mm512_cmp_ps_mask(
+				laneX,
+				_mm512_set1_ps(static_cast<float>(x0 - bx)),
+				_CMP_GE_OQ)
+				& _mm512_cmp_ps_mask(
+					laneX,
+					_mm512_set1_ps(static_cast<float>(ex - bx)),
+					_CMP_LT_OQ);
+
+			for (INT y = y0; y < ey; y += 2)
+			{
+				bool secondRow = y + 1 < ey;
+				__mmask16 rowsMask = secondRow
+					? columnsMask
+					: static_cast<__mmask16>(columnsMask & 0x00FF);
+
+				__mmask16 mask = rowsMask;
+				__m512 pixelDepth = ShadeAVX512(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					laneY,
+					inside,
+					mask);
+
+				float* rows = depth + block + (y - by) * BlockSize;
+				__m512 stored = _mm512_maskz_loadu_ps(rowsMask, rows);
+				_mm512_mask_storeu_ps(
+					rows,
+					mask,
+					_mm512_max_ps(stored, pixelDepth));
+			}
+		});
+}
+
+UINT VisibilityAVX512(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels)
+{
+	TriangleAVX512 t = LoadAVX512(triangle);
+	const __m512 laneX = _mm512_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m512 laneY = _mm512_setr_ps(
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+
+	UINT count = 0;
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m512 x = _mm512_add_ps(
+				_mm512_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__mmask16 columnsMask = _mm512_cmp_ps_mask(
+				laneX,
+				_mm512_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y += 2)
+			{
+				bool secondRow = y + 1 < ey;
+				__mmask16 rowsMask = secondRow
+					? columnsMask
+					: static_cast<__mmask16>(columnsMask & 0x00FF);
+
+				__mmask16 mask = rowsMask;
+				__m512 pixelDepth = ShadeAVX512(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					laneY,
+					inside,
+					mask);
+
+				const float* row0 = depth + y * pitch + bx;
+				const float* row1 = secondRow ? row0 + pitch : row0;
+				__m512 stored = LoadRowsAVX512(row0, row1, rowsMask);
+				mask = _mm512_mask_cmp_ps_mask(
+					mask,
+					stored,
+					pixelDepth,
+					_CMP_EQ_OQ);
+
+				unsigned long lane;
+				UINT bits = mask;
+				while (_BitScanForward(&lane, bits))
+				{
+					visiblePixels[count++] =
+						(bx + (lane & 7)) | ((y + (lane >> 3)) << 16);
+					bits &= bits - 1;
+				}
+			}
+		});
+
+	return count;
+}
+
+// 64 bit lanes, so rows are written separately
+void VisibilityBufferAVX512(
+	const RasterTriangle& triangle,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch)
+{
+	TriangleAVX512 t = LoadAVX512(triangle);
+	const __m512 laneX = _mm512_setr_ps(
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+		0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m512 laneY = _mm512_setr_ps(
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+	const __m512i ids = _mm512_set1_epi64(id);
+
+	ForEachBlock(
+		triangle,
+		width,
+		height,
+		[&](UINT bx, UINT by, UINT ex, UINT ey, bool inside)
+		{
+			__m512 x = _mm512_add_ps(
+				_mm512_set1_ps(static_cast<float>(bx)),
+				laneX);
+			__mmask16 columnsMask = _mm512_cmp_ps_mask(
+				laneX,
+				_mm512_set1_ps(static_cast<float>(ex - bx)),
+				_CMP_LT_OQ);
+
+			for (UINT y = by; y < ey; y += 2)
+			{
+				UINT rowsCount = (y + 1 < ey) ? 2 : 1;
+				__mmask16 mask = (rowsCount == 2)
+					? columnsMask
+					: static_cast<__mmask16>(columnsMask & 0x00FF);
+				__m512 pixelDepth = ShadeAVX512(
+					triangle,
+					t,
+					bx,
+					x,
+					y,
+					laneY,
+					inside,
+					mask);
+
+				__m256i rowsDepth[2] =
+				{
+					_mm256_castps_si256(_mm512_castps512_ps256(pixelDepth)),
+					_mm256_castpd_si256(
+						_mm512_extractf64x4_pd(_mm512_castps_pd(pixelDepth), 1))
+				};
+				for (UINT row = 0; row < rowsCount; row++)
+				{
+					UINT64* dst = visibility + (y + row) * pitch + bx;
+					__mmask8 rowMask = static_cast<__mmask8>(mask >> (8 * row));
+
+					// see PackVisibility
+					__m512i value = _mm512_or_si512(
+						_mm512_slli_epi64(
+							_mm512_cvtepu32_epi64(rowsDepth[row]),
+							32),
+						ids);
+					__m512i stored = _mm512_maskz_loadu_epi64(
+						static_cast<__mmask8>(columnsMask),
+						dst);
+					_mm512_mask_storeu_epi64(
+						dst,
+						_mm512_mask_cmpgt_epi64_mask(rowMask, value, stored),
+						value);
+				}
+			}
+		});
+}
+
+// 16 outputs of 32 pixels of both rows, pairs are picked across
+// both registers at once
+template <bool Max>
+void HiZAVX512(
+	const float* row0,
+	const float* row1,
+	UINT count,
+	float* output)
+{
+	auto reduce = [](__m512 a, __m512 b)
+	{
+		return Max ? _mm512_max_ps(a, b) : _mm512_min_ps(a, b);
+	};
+	const __m512i even = _mm512_setr_epi32(
+		0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+	const __m512i odd = _mm512_add_epi32(even, _mm512_set1_epi32(1));
+
+	UINT x = 0;
+	for (; x + 16 <= count; x += 16)
+	{
+		__m512 low = reduce(
+			_mm512_loadu_ps(row0 + 2 * x),
+			_mm512_loadu_ps(row1 + 2 * x));
+		__m512 high = reduce(
+			_mm512_loadu_ps(row0 + 2 * x + 16),
+			_mm512_loadu_ps(row1 + 2 * x + 16));
+		_mm512_storeu_ps(
+			output + x,
+			reduce(
+				_mm512_permutex2var_ps(low, even, high),
+				_mm512_permutex2var_ps(low, odd, high)));
+	}
+
+	HiZAVX2<Max>(row0 + 2 * x, row1 + 2 * x, count - x, output + x);
+}
+
+const Kernels AllKernels[TypesCount] =
+{
+	{
+		Scalar,
+		"Scalar",
+		DepthScalar,
+		VisibilityScalar,
+		VisibilityBufferScalar,
+		DepthMicroScalar,
+		TiledDepthScalar,
+		HiZScalar<false>,
+		HiZScalar<true>
+	},
+	{
+		AVX2,
+		"AVX2",
+		DepthAVX2,
+		VisibilityAVX2,
+		VisibilityBufferAVX2,
+		DepthMicroAVX2,
+		TiledDepthAVX2,
+		HiZAVX2<false>,
+		HiZAVX2<true>
+	},
+	{
+		AVX512,
+		"AVX-512",
+		DepthAVX512,
+		VisibilityAVX512,
+		VisibilityBufferAVX512,
+		// a batch is 8 lanes, AVX-512 implies AVX2
+		DepthMicroAVX2,
+		TiledDepthAVX512,
+		HiZAVX512<false>,
+		HiZAVX512<true>
+	}
+};
+
+}
+
+bool IsSupported(Type type)
+{
+	if (type == Scalar)
+	{
+		return true;
+	}
+
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	if (maxLeaf < 7)
+	{
+		return false;
+	}
+
+	__cpuid(info, 1);
+	bool OSXSAVE = (info[2] & (1 << 27)) != 0;
+	bool AVX = (info[2] & (1 << 28)) != 0;
+	if (!OSXSAVE || !AVX)
+	{
+		return false;
+	}
+
+	// registers state saved by the OS: XMM | YMM, opmask | ZMM
+	unsigned long long XCR0 = _xgetbv(0);
+	bool YMMState = (XCR0 & 0x6) == 0x6;
+	bool ZMMState = (XCR0 & 0xE6) == 0xE6;
+
+	__cpuidex(info, 7, 0);
+	bool AVX2Supported = (info[1] & (1 << 5)) != 0;
+	bool AVX512FSupported = (info[1] & (1 << 16)) != 0;
+
+	switch (type)
+	{
+	case AVX2:
+		return YMMState && AVX2Supported;
+	case AVX512:
+		return ZMMState && AVX512FSupported;
+	default:
+		return false;
+	}
+}
+
+Type DetectBest()
+{
+	for (INT type = TypesCount - 1; type > Scalar; type--)
+	{
+		if (IsSupported(static_cast<Type>(type)))
+		{
+			return static_cast<Type>(type);
+		}
+	}
+
+	return Scalar;
+}
+
+const Kernels& Get(Type type)
+{
+	assert(type < TypesCount);
+	return AllKernels[type];
+}
+
+void DepthSmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch)
+{
+	for (UINT y = 0; y < height; y++)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			if (IsCovered(t, x, y))
+			{
+				float& dst = depth[y * pitch + x];
+				dst = std::max(
+					dst,
+					PlaneDepth(
+						t,
+						static_cast<float>(x),
+						static_cast<float>(y)));
+			}
+		}
+	}
+}
+
+void TiledDepthSmall(
+	const RasterTriangle& t,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX)
+{
+	for (UINT y = 0; y < height; y++)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			if (IsCovered(t, x, y))
+			{
+				float& dst =
+					depth[TiledOffset(originX + x, originY + y, blocksX)];
+				dst = std::max(
+					dst,
+					PlaneDepth(
+						t,
+						static_cast<float>(x),
+						static_cast<float>(y)));
+			}
+		}
+	}
+}
+
+UINT VisibilitySmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels)
+{
+	UINT count = 0;
+	for (UINT y = 0; y < height; y++)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			if (IsCovered(t, x, y) && depth[y * pitch + x] == PlaneDepth(
+				t,
+				static_cast<float>(x),
+				static_cast<float>(y)))
+			{
+				visiblePixels[count++] = x | (y << 16);
+			}
+		}
+	}
+
+	return count;
+}
+
+
+void VisibilityBufferSmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch)
+{
+	for (UINT y = 0; y < height; y++)
+	{
+		for (UINT x = 0; x < width; x++)
+		{
+			if (IsCovered(t, x, y))
+			{
+				MaxVisibility(
+					visibility[y * pitch + x],
+					PackVisibility(
+						PlaneDepth(
+							t,
+							static_cast<float>(x),
+							static_cast<float>(y)),
+						id));
+			}
+		}
+	}
+}
+
+void Detile(
+	const float* tiled,
+	UINT width,
+	UINT firstRow,
+	UINT rowsCount,
+	float* rowMajor)
+{
+	UINT blocksX = TiledBlocksCount(width);
+	for (UINT y = firstRow; y < firstRow + rowsCount; y++)
+	{
+		const float* block = tiled + TiledOffset(0, y, blocksX);
+		float* row = rowMajor + y * width;
+		UINT x = 0;
+		// of a constant size, so it's a single move
+		for (; x + BlockSize <= width; x += BlockSize, block += BlockPixels)
+		{
+			memcpy(row + x, block, sizeof(float) * BlockSize);
+		}
+		memcpy(row + x, block, sizeof(float) * (width - x));
+	}
+}
+
+}
\ No newline at end of file
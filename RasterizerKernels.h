@@ -0,0 +1,377 @@
+#pragma once
+
+#include "Common.h"
+
+#include <cstring>
+
+// a triangle over a rect of pixel centers, everything is evaluated
+// at offsets from the rect's origin the same way BigTriangleDepthCS
+// does it, instead of accumulating per pixel,
+// so every kernel and both depth and opaque passes get bit exact depths
+//
+// coverage is decided by the exact fixed point edge functions,
+// depth comes from its plane, float edge functions are used for
+// barycentric weights of shading only
+struct RasterTriangle
+{
+	// at the origin pixel center
+	float area0;
+	float area1;
+	float area2;
+	// E(x + a, y + b) = E(x, y) - a * dy + b * dx
+	DirectX::XMFLOAT2 dxdy0;
+	DirectX::XMFLOAT2 dxdy1;
+	DirectX::XMFLOAT2 dxdy2;
+	float invArea;
+
+	// z in NDC at the origin pixel center and its per pixel steps
+	float depth;
+	float depthDx;
+	float depthDy;
+
+	// in 1 / SubpixelScale ^ 2 of a pixel at the origin pixel center,
+	// biased by the top-left rule, so a pixel is covered if all are >= 0
+	INT64 edge0;
+	INT64 edge1;
+	INT64 edge2;
+	// per pixel steps, same as dxdy
+	INT64 edgeDx0;
+	INT64 edgeDy0;
+	INT64 edgeDx1;
+	INT64 edgeDy1;
+	INT64 edgeDx2;
+	INT64 edgeDy2;
+};
+
+// CPU rasterizer inner loops, the best one is picked at runtime
+namespace RasterizerKernels
+{
+
+// blocks are trivially accepted or rejected by their corners
+static const UINT BlockSize = 8;
+
+// depth only targets may be tiled into blocks, stored a row of blocks
+// after another, with the pixels of a block row by row, so a block is
+// a few cache lines and a row of the kernels never spans two of them
+static const UINT BlockPixels = BlockSize * BlockSize;
+
+// along either side of a tiled target
+inline UINT TiledBlocksCount(UINT size)
+{
+	return (size + BlockSize - 1) / BlockSize;
+}
+
+// of a tiled target, padded to whole blocks
+inline UINT TiledSize(UINT width, UINT height)
+{
+	return TiledBlocksCount(width) * TiledBlocksCount(height) * BlockPixels;
+}
+
+inline UINT TiledOffset(UINT x, UINT y, UINT blocksX)
+{
+	return ((y / BlockSize) * blocksX + x / BlockSize) * BlockPixels
+		+ (y % BlockSize) * BlockSize + x % BlockSize;
+}
+
+// vertices are snapped to 1 / SubpixelScale of a pixel
+static const UINT SubpixelBits = 8;
+static const INT SubpixelScale = 1 << SubpixelBits;
+
+// micro triangles of at most 2x2 pixel centers are rasterized
+// in batches, a triangle per SIMD lane
+static const UINT MicroBatchSize = 8;
+// of the vertices from the first pixel center, so the fixed point
+// edge functions of a micro triangle fit 32 bits
+static const INT MicroMaxOffset = 4 * SubpixelScale;
+
+// SoA of a batch, set up from the triangles directly, skipping
+// their RasterTriangle, depths are the same as of it though
+struct alignas(32) MicroTriangles
+{
+	// snapped, from the first pixel center, in 1 / SubpixelScale of a pixel
+	INT x0[MicroBatchSize];
+	INT y0[MicroBatchSize];
+	INT x1[MicroBatchSize];
+	INT y1[MicroBatchSize];
+	INT x2[MicroBatchSize];
+	INT y2[MicroBatchSize];
+	// snapped, in pixels
+	float p0x[MicroBatchSize];
+	float p0y[MicroBatchSize];
+	float p1x[MicroBatchSize];
+	float p1y[MicroBatchSize];
+	float p2x[MicroBatchSize];
+	float p2y[MicroBatchSize];
+	// the first pixel center
+	float originX[MicroBatchSize];
+	float originY[MicroBatchSize];
+	float z0[MicroBatchSize];
+	float z1[MicroBatchSize];
+	float z2[MicroBatchSize];
+	float invArea[MicroBatchSize];
+	// pixel centers to test, 1 or 2 per axis
+	INT width[MicroBatchSize];
+	INT height[MicroBatchSize];
+	// of the first pixel center into depth
+	UINT offset[MicroBatchSize];
+	UINT count;
+};
+
+enum Type
+{
+	Scalar,
+	// 8x1 pixels per instruction
+	AVX2,
+	// 8x2 pixels per instruction
+	AVX512,
+	TypesCount
+};
+
+// max of depth for covered pixels of [0, width) x [0, height)
+using DepthKernel = void (*)(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch);
+
+// DepthKernel of a tiled target, blocksX per row of blocks,
+// the pixels are [originX, originX + width) x [originY, originY + height),
+// and t is set up at the origin, as for DepthKernel, so depths are
+// the same, rows are walked by blocks of the target
+using TiledDepthKernel = void (*)(
+	const RasterTriangle& t,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX);
+
+// writes (x | y << 16) of covered pixels with depth equal to the stored one,
+// returns their count, visiblePixels should fit width * height
+using VisibilityKernel = UINT (*)(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels);
+
+// max of PackVisibility(depth, id) for covered pixels, compared as signed,
+// so negative depths never win against the cleared 0, as in DepthKernel
+using VisibilityBufferKernel = void (*)(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch);
+
+// DepthKernel of a batch, evaluates the few pixel centers
+// of every triangle directly
+using MicroDepthKernel = void (*)(
+	const MicroTriangles& triangles,
+	float* depth,
+	UINT pitch);
+
+// a row of a Hi-Z mip, the min of the 2x2 pixels of row0 and row1
+// above every output, so the farthest reversed Z depth, or the max,
+// the nearest one, the rows hold 2 * count pixels
+using HiZKernel = void (*)(
+	const float* row0,
+	const float* row1,
+	UINT count,
+	float* output);
+
+struct Kernels
+{
+	Type type;
+	const char* name;
+	DepthKernel depth;
+	VisibilityKernel visibility;
+	VisibilityBufferKernel visibilityBuffer;
+	MicroDepthKernel microDepth;
+	TiledDepthKernel tiledDepth;
+	HiZKernel hiZMin;
+	HiZKernel hiZMax;
+};
+
+bool IsSupported(Type type);
+Type DetectBest();
+const Kernels& Get(Type type);
+
+// for small triangles, every pixel is tested without classifying blocks,
+// which costs more than the few pixels of their bounding box,
+// results are the same as of the kernels above
+void DepthSmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT pitch);
+void TiledDepthSmall(
+	const RasterTriangle& t,
+	UINT originX,
+	UINT originY,
+	UINT width,
+	UINT height,
+	float* depth,
+	UINT blocksX);
+UINT VisibilitySmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	const float* depth,
+	UINT pitch,
+	UINT* visiblePixels);
+void VisibilityBufferSmall(
+	const RasterTriangle& t,
+	UINT width,
+	UINT height,
+	UINT id,
+	UINT64* visibility,
+	UINT pitch);
+
+// rows [firstRow, firstRow + rowsCount) to the same rows of a row-major
+// target, a row of a block at a time
+void Detile(
+	const float* tiled,
+	UINT width,
+	UINT firstRow,
+	UINT rowsCount,
+	float* rowMajor);
+
+// per pixel math shared by all kernels and shading
+
+inline void EdgeFunctions(
+	const RasterTriangle& t,
+	float x,
+	float y,
+	float& area0,
+	float& area1,
+	float& area2)
+{
+	area0 = t.area0 - x * t.dxdy0.y + y * t.dxdy0.x;
+	area1 = t.area1 - x * t.dxdy1.y + y * t.dxdy1.x;
+	area2 = t.area2 - x * t.dxdy2.y + y * t.dxdy2.x;
+}
+
+inline void BarycentricWeights(
+	const RasterTriangle& t,
+	float area0,
+	float area1,
+	float& weight0,
+	float& weight1,
+	float& weight2)
+{
+	weight0 = area0 * t.invArea;
+	weight1 = area1 * t.invArea;
+	weight2 = 1.0f - weight0 - weight1;
+}
+
+// a single plane evaluation, no weights needed
+inline float PlaneDepth(const RasterTriangle& t, float x, float y)
+{
+	return t.depth + x * t.depthDx + y * t.depthDy;
+}
+
+// depth in the high bits, so the max is the closest one with reversed Z,
+// bits of non-negative floats are ordered the same way as the floats,
+// equal depths are resolved by the id, 0 is left for no triangle
+inline UINT64 PackVisibility(float depth, UINT id)
+{
+	UINT depthBits;
+	std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+	return (static_cast<UINT64>(depthBits) << 32) | id;
+}
+
+inline float UnpackVisibilityDepth(UINT64 visibility)
+{
+	UINT depthBits = static_cast<UINT>(visibility >> 32);
+	float depth;
+	std::memcpy(&depth, &depthBits, sizeof(depth));
+
+	return depth;
+}
+
+inline UINT UnpackVisibilityID(UINT64 visibility)
+{
+	return static_cast<UINT>(visibility & 0xFFFFFFFF);
+}
+
+// x and y may be negative for the pixels before the origin
+// of the first block of a tiled target
+inline void FixedPointEdgeFunctions(
+	const RasterTriangle& t,
+	INT x,
+	INT y,
+	INT64& edge0,
+	INT64& edge1,
+	INT64& edge2)
+{
+	edge0 = t.edge0 - x * t.edgeDy0 + y * t.edgeDx0;
+	edge1 = t.edge1 - x * t.edgeDy1 + y * t.edgeDx1;
+	edge2 = t.edge2 - x * t.edgeDy2 + y * t.edgeDx2;
+}
+
+inline bool IsCovered(const RasterTriangle& t, UINT x, UINT y)
+{
+	INT64 edge0, edge1, edge2;
+	FixedPointEdgeFunctions(t, x, y, edge0, edge1, edge2);
+
+	// sign bit is set if any of them is negative
+	return (edge0 | edge1 | edge2) >= 0;
+}
+
+enum BlockCoverage
+{
+	Outside,
+	Partial,
+	Inside
+};
+
+// x0, y0, x1, y1 - inclusive pixel offsets of the block,
+// edge functions are linear, so corners bound the whole block
+inline BlockCoverage ClassifyBlock(
+	const RasterTriangle& t,
+	UINT x0,
+	UINT y0,
+	UINT x1,
+	UINT y1)
+{
+	INT64 corners[4][3];
+	UINT xs[4] = { x0, x1, x0, x1 };
+	UINT ys[4] = { y0, y0, y1, y1 };
+	for (UINT corner = 0; corner < 4; corner++)
+	{
+		FixedPointEdgeFunctions(
+			t,
+			xs[corner],
+			ys[corner],
+			corners[corner][0],
+			corners[corner][1],
+			corners[corner][2]);
+	}
+
+	bool inside = true;
+	for (UINT edge = 0; edge < 3; edge++)
+	{
+		UINT insideCorners = 0;
+		for (UINT corner = 0; corner < 4; corner++)
+		{
+			insideCorners += (corners[corner][edge] >= 0) ? 1 : 0;
+		}
+
+		if (insideCorners == 0)
+		{
+			return Outside;
+		}
+		inside = inside && (insideCorners == 4);
+	}
+
+	return inside ? Inside : Partial;
+}
+
+}
\ No newline at end of file
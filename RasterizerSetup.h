@@ -0,0 +1,505 @@
+#pragma once
+
+#include "CPURasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// triangle clipping and raster setup of the CPU rasterizer,
+// shared by its diagnostics
+namespace RasterizerSetup
+{
+
+// CPU duplicates of Rasterization.hlsli helpers
+
+inline void EdgeFunction(
+	const DirectX::XMFLOAT2& v0,
+	const DirectX::XMFLOAT2& v1,
+	const DirectX::XMFLOAT2& p,
+	float& area,
+	DirectX::XMFLOAT2& dxdy)
+{
+	DirectX::XMFLOAT2 e0 = { v1.x - v0.x, v1.y - v0.y };
+	DirectX::XMFLOAT2 e1 = { p.x - v0.x, p.y - v0.y };
+	area = e0.x * e1.y - e1.x * e0.y;
+	dxdy = e0;
+}
+
+inline float SnapMinBoundToPixelCenter(float minP)
+{
+	return std::ceil(minP - 0.5f) + 0.5f;
+}
+
+// exact, unlike the float one, positions are in 1 / SubpixelScale
+// of a pixel within the guard band, so it fits 64 bits
+inline INT64 FixedPointArea(
+	const DirectX::XMINT2& v0,
+	const DirectX::XMINT2& v1,
+	const DirectX::XMINT2& v2)
+{
+	INT64 e0x = static_cast<INT64>(v1.x) - v0.x;
+	INT64 e0y = static_cast<INT64>(v1.y) - v0.y;
+	INT64 e1x = static_cast<INT64>(v2.x) - v0.x;
+	INT64 e1y = static_cast<INT64>(v2.y) - v0.y;
+	return e0x * e1y - e1x * e0y;
+}
+
+// a pixel center on an edge shared by two triangles gets exact 0 for both,
+// the top-left rule gives it to one of them
+inline void FixedPointEdgeFunction(
+	const DirectX::XMINT2& v0,
+	const DirectX::XMINT2& v1,
+	const DirectX::XMINT2& p,
+	INT64& edge,
+	INT64& edgeDx,
+	INT64& edgeDy)
+{
+	INT64 e0x = static_cast<INT64>(v1.x) - v0.x;
+	INT64 e0y = static_cast<INT64>(v1.y) - v0.y;
+	edge = FixedPointArea(v0, v1, p);
+
+	// inside is on the right of an edge in the y down screen space,
+	// so a top edge is horizontal and goes right, a left one goes up
+	bool topLeft = e0y < 0 || (e0y == 0 && e0x > 0);
+	if (!topLeft)
+	{
+		edge -= 1;
+	}
+
+	// one pixel step
+	edgeDx = e0x * RasterizerKernels::SubpixelScale;
+	edgeDy = e0y * RasterizerKernels::SubpixelScale;
+}
+
+inline DirectX::XMINT2 ToFixedPoint(const DirectX::XMFLOAT2& p)
+{
+	const float scale = static_cast<float>(RasterizerKernels::SubpixelScale);
+
+	return
+	{
+		static_cast<INT>(std::lround(p.x * scale)),
+		static_cast<INT>(std::lround(p.y * scale))
+	};
+}
+
+inline DirectX::XMFLOAT2 FromFixedPoint(const DirectX::XMINT2& p)
+{
+	const float scale = static_cast<float>(RasterizerKernels::SubpixelScale);
+
+	return { static_cast<float>(p.x) / scale, static_cast<float>(p.y) / scale };
+}
+
+// in pixels, fixed point edge functions don't overflow within it
+const float GuardBand = static_cast<float>(1 << 20);
+
+struct ClipVertex
+{
+	DirectX::XMFLOAT4 positionCS;
+	// within the original triangle
+	DirectX::XMFLOAT3 barycentrics;
+};
+
+// every plane adds one vertex at most
+const UINT MaxClippedVertices = 3 + 5;
+
+inline float PlaneDistance(
+	const DirectX::XMFLOAT4& plane,
+	const DirectX::XMFLOAT4& p)
+{
+	return plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w * p.w;
+}
+
+inline bool IsInside(
+	const DirectX::XMFLOAT4* planes,
+	UINT planesCount,
+	const DirectX::XMFLOAT4& p)
+{
+	for (UINT plane = 0; plane < planesCount; plane++)
+	{
+		if (PlaneDistance(planes[plane], p) < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+inline ClipVertex Intersect(
+	const ClipVertex& inside,
+	const ClipVertex& outside,
+	float insideDistance,
+	float outsideDistance)
+{
+	// always from the inside vertex, so an edge shared by two triangles
+	// is split at exactly the same point for both of them
+	float t = insideDistance / (insideDistance - outsideDistance);
+
+	ClipVertex result;
+	DirectX::XMStoreFloat4(
+		&result.positionCS,
+		DirectX::XMVectorLerp(
+			DirectX::XMLoadFloat4(&inside.positionCS),
+			DirectX::XMLoadFloat4(&outside.positionCS),
+			t));
+	DirectX::XMStoreFloat3(
+		&result.barycentrics,
+		DirectX::XMVectorLerp(
+			DirectX::XMLoadFloat3(&inside.barycentrics),
+			DirectX::XMLoadFloat3(&outside.barycentrics),
+			t));
+
+	return result;
+}
+
+// Sutherland-Hodgman in clip space, polygon holds the triangle
+// and gets the clipped convex polygon, returns its vertices count,
+// 0 if it's completely outside
+inline UINT ClipTriangle(
+	const DirectX::XMFLOAT4* planes,
+	UINT planesCount,
+	ClipVertex (&polygon)[MaxClippedVertices])
+{
+	UINT verticesCount = 3;
+	for (UINT plane = 0; plane < planesCount; plane++)
+	{
+		float distances[MaxClippedVertices];
+		bool anyOutside = false;
+		for (UINT vertex = 0; vertex < verticesCount; vertex++)
+		{
+			distances[vertex] =
+				PlaneDistance(planes[plane], polygon[vertex].positionCS);
+			anyOutside = anyOutside || distances[vertex] < 0.0f;
+		}
+		if (!anyOutside)
+		{
+			continue;
+		}
+
+		ClipVertex clipped[MaxClippedVertices];
+		UINT clippedCount = 0;
+		for (UINT vertex = 0; vertex < verticesCount; vertex++)
+		{
+			UINT next = (vertex + 1) % verticesCount;
+			bool inside = distances[vertex] >= 0.0f;
+			bool nextInside = distances[next] >= 0.0f;
+
+			if (inside)
+			{
+				clipped[clippedCount++] = polygon[vertex];
+			}
+			if (inside && !nextInside)
+			{
+				clipped[clippedCount++] = Intersect(
+					polygon[vertex], polygon[next],
+					distances[vertex], distances[next]);
+			}
+			else if (!inside && nextInside)
+			{
+				clipped[clippedCount++] = Intersect(
+					polygon[next], polygon[vertex],
+					distances[next], distances[vertex]);
+			}
+		}
+
+		if (clippedCount < 3)
+		{
+			return 0;
+		}
+
+		verticesCount = clippedCount;
+		std::copy(clipped, clipped + clippedCount, polygon);
+	}
+
+	return verticesCount;
+}
+
+// the near plane goes first, then the guard band ones
+inline void SetClipPlanes(
+	const DirectX::XMFLOAT4& nearPlane,
+	UINT width,
+	UINT height,
+	DirectX::XMFLOAT4* planes)
+{
+	// |x| <= w * guardBandX in CS is within half of GuardBand in SS,
+	// the rest is a margin for the float error of clipping
+	float guardBandX = GuardBand / static_cast<float>(width) - 1.0f;
+	float guardBandY = GuardBand / static_cast<float>(height) - 1.0f;
+
+	planes[0] = nearPlane;
+	planes[1] = { 1.0f, 0.0f, 0.0f, guardBandX };
+	planes[2] = { -1.0f, 0.0f, 0.0f, guardBandX };
+	planes[3] = { 0.0f, 1.0f, 0.0f, guardBandY };
+	planes[4] = { 0.0f, -1.0f, 0.0f, guardBandY };
+}
+
+// snaps vertices to the sub-pixel grid and finds pixel centers to test,
+// false if the triangle is back facing or covers none of them,
+// the reason is stored to rejection if given
+template <typename Setup>
+bool SetupScreenTriangle(
+	Setup& t,
+	float width,
+	float height,
+	CPURasterizer::RejectionReasons* rejection = nullptr)
+{
+	auto reject = [rejection](CPURasterizer::RejectionReasons reason)
+	{
+		if (rejection)
+		{
+			*rejection = reason;
+		}
+		return false;
+	};
+
+
+	DirectX::XMFLOAT2* positions[3] = { &t.p0SS, &t.p1SS, &t.p2SS };
+	DirectX::XMINT2* fixedPositions[3] = { &t.p0Fixed, &t.p1Fixed, &t.p2Fixed };
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		DirectX::XMFLOAT2& p = *positions[vertex];
+		if (!(std::abs(p.x) <= GuardBand && std::abs(p.y) <= GuardBand))
+		{
+			return reject(CPURasterizer::OffScreen);
+		}
+
+		*fixedPositions[vertex] = ToFixedPoint(p);
+		p = FromFixedPoint(*fixedPositions[vertex]);
+	}
+
+	INT64 area = FixedPointArea(t.p0Fixed, t.p1Fixed, t.p2Fixed);
+
+	// backface if negative
+	if (area <= 0)
+	{
+		return reject(CPURasterizer::BackFacing);
+	}
+
+	const float subpixelArea = static_cast<float>(
+		RasterizerKernels::SubpixelScale * RasterizerKernels::SubpixelScale);
+	t.invArea = subpixelArea / static_cast<float>(area);
+
+	t.minP =
+	{
+		std::min(std::min(t.p0SS.x, t.p1SS.x), t.p2SS.x),
+		std::min(std::min(t.p0SS.y, t.p1SS.y), t.p2SS.y)
+	};
+	t.maxP =
+	{
+		std::max(std::max(t.p0SS.x, t.p1SS.x), t.p2SS.x),
+		std::max(std::max(t.p0SS.y, t.p1SS.y), t.p2SS.y)
+	};
+
+	// frustum culling
+	if (t.minP.x >= width || t.maxP.x < 0.0f
+		|| t.maxP.y < 0.0f || t.minP.y >= height)
+	{
+		return reject(CPURasterizer::OffScreen);
+	}
+
+	t.minP.x = std::clamp(t.minP.x, 0.0f, width);
+	t.minP.y = std::clamp(t.minP.y, 0.0f, height);
+	t.maxP.x = std::clamp(t.maxP.x, 0.0f, width);
+	t.maxP.y = std::clamp(t.maxP.y, 0.0f, height);
+
+	t.minP.x = SnapMinBoundToPixelCenter(t.minP.x);
+	t.minP.y = SnapMinBoundToPixelCenter(t.minP.y);
+
+	// small triangles between pixel centers,
+	// exact instead of the round() test of TriangleDepthCS,
+	// which drops the ones with a vertex right on a pixel center
+	if (t.minP.x > t.maxP.x || t.minP.y > t.maxP.y)
+	{
+		return reject(CPURasterizer::BetweenPixelCenters);
+	}
+
+	return true;
+}
+
+// CS -> NDC -> DX [0,1] -> SS, then SetupScreenTriangle
+template <typename Setup>
+bool ProjectTriangle(
+	const ClipVertex& v0,
+	const ClipVertex& v1,
+	const ClipVertex& v2,
+	float width,
+	float height,
+	Setup& t,
+	CPURasterizer::RejectionReasons* rejection = nullptr)
+{
+	const ClipVertex* vertices[3] = { &v0, &v1, &v2 };
+	float* invW[3] = { &t.invW0, &t.invW1, &t.invW2 };
+	DirectX::XMFLOAT2* pSS[3] = { &t.p0SS, &t.p1SS, &t.p2SS };
+	float* zNDC[3] = { &t.z0NDC, &t.z1NDC, &t.z2NDC };
+	DirectX::XMFLOAT3* barycentrics[3] =
+	{
+		&t.barycentrics0,
+		&t.barycentrics1,
+		&t.barycentrics2
+	};
+
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		const DirectX::XMFLOAT4& pCS = vertices[vertex]->positionCS;
+
+		// 1 / z for each vertex (z in VS)
+		*invW[vertex] = 1.0f / pCS.w;
+		*pSS[vertex] =
+		{
+			(pCS.x * *invW[vertex] * 0.5f + 0.5f) * width,
+			(pCS.y * *invW[vertex] * -0.5f + 0.5f) * height
+		};
+		*zNDC[vertex] = pCS.z * *invW[vertex];
+		*barycentrics[vertex] = vertices[vertex]->barycentrics;
+	}
+
+	return SetupScreenTriangle(t, width, height, rejection);
+}
+
+// ProjectTriangle for w = 1, as of orthographic projections,
+// CS is NDC already, so there is nothing to divide by,
+// for the depth pass only, so no barycentrics
+template <typename Setup>
+bool ProjectOrthographicTriangle(
+	const DirectX::XMFLOAT4& p0CS,
+	const DirectX::XMFLOAT4& p1CS,
+	const DirectX::XMFLOAT4& p2CS,
+	float width,
+	float height,
+	Setup& t,
+	CPURasterizer::RejectionReasons* rejection = nullptr)
+{
+	const DirectX::XMFLOAT4* positionsCS[3] = { &p0CS, &p1CS, &p2CS };
+	float* invW[3] = { &t.invW0, &t.invW1, &t.invW2 };
+	DirectX::XMFLOAT2* pSS[3] = { &t.p0SS, &t.p1SS, &t.p2SS };
+	float* zNDC[3] = { &t.z0NDC, &t.z1NDC, &t.z2NDC };
+
+	for (UINT vertex = 0; vertex < 3; vertex++)
+	{
+		const DirectX::XMFLOAT4& pCS = *positionsCS[vertex];
+
+		*invW[vertex] = 1.0f;
+		*pSS[vertex] =
+		{
+			(pCS.x * 0.5f + 0.5f) * width,
+			(pCS.y * -0.5f + 0.5f) * height
+		};
+		*zNDC[vertex] = pCS.z;
+	}
+
+	return SetupScreenTriangle(t, width, height, rejection);
+}
+
+// first and last pixel centers of the tile
+inline void GetTileBounds(
+	UINT tileX,
+	UINT tileY,
+	UINT tileSize,
+	DirectX::XMFLOAT2& tileMinP,
+	DirectX::XMFLOAT2& tileMaxP)
+{
+	tileMinP =
+	{
+		static_cast<float>(tileX * tileSize) + 0.5f,
+		static_cast<float>(tileY * tileSize) + 0.5f
+	};
+	tileMaxP =
+	{
+		tileMinP.x + static_cast<float>(tileSize - 1),
+		tileMinP.y + static_cast<float>(tileSize - 1)
+	};
+}
+
+// clips the triangle's bounding box by the tile,
+// edge functions are evaluated at the clipped corner,
+// the same way BigTriangleDepthCS does it per tile
+template <typename Setup>
+bool SetupTileRaster(
+	const Setup& t,
+	const DirectX::XMFLOAT2& tileMinP,
+	const DirectX::XMFLOAT2& tileMaxP,
+	RasterTriangle& raster,
+	UINT& originX,
+	UINT& originY,
+	UINT& width,
+	UINT& height)
+{
+	DirectX::XMFLOAT2 minP =
+	{
+		std::max(t.minP.x, tileMinP.x),
+		std::max(t.minP.y, tileMinP.y)
+	};
+	DirectX::XMFLOAT2 maxP =
+	{
+		std::min(t.maxP.x, tileMaxP.x),
+		std::min(t.maxP.y, tileMaxP.y)
+	};
+	if (minP.x > maxP.x || minP.y > maxP.y)
+	{
+		return false;
+	}
+
+	// https://www.cs.drexel.edu/~david/Classes/Papers/comp175-06-pineda.pdf
+	EdgeFunction(t.p1SS, t.p2SS, minP, raster.area0, raster.dxdy0);
+	EdgeFunction(t.p2SS, t.p0SS, minP, raster.area1, raster.dxdy1);
+	EdgeFunction(t.p0SS, t.p1SS, minP, raster.area2, raster.dxdy2);
+	DirectX::XMINT2 minPFixed = ToFixedPoint(minP);
+	FixedPointEdgeFunction(
+		t.p1Fixed, t.p2Fixed, minPFixed,
+		raster.edge0, raster.edgeDx0, raster.edgeDy0);
+	FixedPointEdgeFunction(
+		t.p2Fixed, t.p0Fixed, minPFixed,
+		raster.edge1, raster.edgeDx1, raster.edgeDy1);
+	FixedPointEdgeFunction(
+		t.p0Fixed, t.p1Fixed, minPFixed,
+		raster.edge2, raster.edgeDx2, raster.edgeDy2);
+	raster.invArea = t.invArea;
+
+	// z = z2 + w0 * (z0 - z2) + w1 * (z1 - z2), linear in screen space
+	float z02 = (t.z0NDC - t.z2NDC) * t.invArea;
+	float z12 = (t.z1NDC - t.z2NDC) * t.invArea;
+	raster.depth = t.z2NDC + raster.area0 * z02 + raster.area1 * z12;
+	raster.depthDx = -(raster.dxdy0.y * z02 + raster.dxdy1.y * z12);
+	raster.depthDy = raster.dxdy0.x * z02 + raster.dxdy1.x * z12;
+
+	// pixel centers within [minP, maxP]
+	originX = static_cast<UINT>(minP.x);
+	originY = static_cast<UINT>(minP.y);
+	width = static_cast<UINT>(maxP.x - minP.x) + 1;
+	height = static_cast<UINT>(maxP.y - minP.y) + 1;
+
+	return true;
+}
+
+// coarse level, the tile's part within the bounding box
+// of the triangle against its edges
+template <typename Setup>
+RasterizerKernels::BlockCoverage ClassifyTile(
+	const Setup& t,
+	UINT tileX,
+	UINT tileY,
+	UINT tileSize)
+{
+	DirectX::XMFLOAT2 tileMinP, tileMaxP;
+	GetTileBounds(tileX, tileY, tileSize, tileMinP, tileMaxP);
+
+	RasterTriangle raster;
+	UINT originX, originY, width, height;
+	if (!SetupTileRaster(
+		t,
+		tileMinP,
+		tileMaxP,
+		raster,
+		originX, originY,
+		width, height))
+	{
+		return RasterizerKernels::Outside;
+	}
+
+	return RasterizerKernels::ClassifyBlock(
+		raster,
+		0, 0,
+		width - 1, height - 1);
+}
+
+}
\ No newline at end of file
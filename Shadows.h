@@ -1,108 +1,144 @@
-#pragma once
-
-#include "Settings.h"
-#include "Types.h"
-
-class ShadowsResources
-{
-public:
-
-	static ShadowsResources Shadows;
-
-	ShadowsResources() = default;
-	ShadowsResources(const ShadowsResources&) = delete;
-	ShadowsResources& operator=(const ShadowsResources&) = delete;
-	~ShadowsResources() = default;
-
-	void Initialize();
-	void Update();
-	void PreparePrevFrameShadowMap();
-
-	void GUINewFrame();
-
-	ID3D12Resource* GetShadowMapHWR() { return _shadowMapHWR.Get(); }
-	ID3D12Resource* GetShadowMapSWR() { return _shadowMapSWR.Get(); }
-	ID3D12PipelineState* GetPSO() { return _shadowsPSO.Get(); }
-	const CD3DX12_VIEWPORT& GetViewport() { return _viewport; }
-	const CD3DX12_RECT& GetScissorRect() { return _scissorRect; }
-
-	const DirectX::XMFLOAT4X4& GetCascadeVP(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeVP[cascade];
-	}
-	const DirectX::XMFLOAT4X4& GetPrevFrameCascadeVP(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _prevFrameCascadeVP[cascade];
-	}
-	float GetCascadeBias(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeBias[cascade];
-	}
-	float GetCascadeSplitNormalized(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeSplitsNormalized[cascade];
-	}
-	float GetCascadeSplit(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeSplits[cascade];
-	}
-	const Frustum& GetCascadeFrustum(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeFrustums[cascade];
-	}
-	const DirectX::XMFLOAT4& GetCascadeCameraPosition(UINT cascade) const
-	{
-		assert(cascade < Settings::MaxCascadesCount);
-		return _cascadeCameraPosition[cascade];
-	}
-
-	bool ShowCascades() const { return _showCascades; }
-
-private:
-
-	static const float ShadowMinDistance;
-
-	void _createHWRShadowMapResources();
-	void _createSWRShadowMapResources();
-	void _createPrevFrameShadowMapResources();
-	void _createPSO();
-	void _updateFrustumPlanes();
-	void _computeNearAndFar(
-		FLOAT& fNearPlane,
-		FLOAT& fFarPlane,
-		DirectX::FXMVECTOR vLightCameraOrthographicMin,
-		DirectX::FXMVECTOR vLightCameraOrthographicMax,
-		DirectX::XMVECTOR* pvPointsInCameraView);
-
-	Microsoft::WRL::ComPtr<ID3D12RootSignature> _shadowsRS;
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> _shadowsPSO;
-	// for hardware rasterizer pipeline
-	Microsoft::WRL::ComPtr<ID3D12Resource> _shadowMapHWR;
-	// SWR needs unordered writes
-	Microsoft::WRL::ComPtr<ID3D12Resource> _shadowMapSWR;
-	// for Hi-Z culling
-	Microsoft::WRL::ComPtr<ID3D12Resource> _prevFrameShadowMap;
-	CD3DX12_VIEWPORT _viewport;
-	CD3DX12_RECT _scissorRect;
-
-	DirectX::XMFLOAT4 _cascadeCameraPosition[Settings::MaxCascadesCount];
-	DirectX::XMFLOAT4X4 _cascadeVP[Settings::MaxCascadesCount];
-	DirectX::XMFLOAT4X4 _prevFrameCascadeVP[Settings::MaxCascadesCount];
-	Frustum _cascadeFrustums[Settings::MaxCascadesCount];
-	float _cascadeBias[Settings::MaxCascadesCount];
-	float _cascadeSplitsNormalized[Settings::MaxCascadesCount];
-	float _cascadeSplits[Settings::MaxCascadesCount];
-	UINT _cascadesCount;
-	float _shadowDistance = 5000.0f;
-	bool _boundCascadesBySpheres = false;
-	float _bias = 0.001f;
-
-	// debug and visualisation stuff
-	bool _showCascades = false;
+#pragma once
+
+#include "Settings.h"
+#include "Types.h"
+
+class Scene;
+
+class ShadowsResources
+{
+public:
+
+	static ShadowsResources Shadows;
+
+	ShadowsResources() = default;
+	ShadowsResources(const ShadowsResources&) = delete;
+	ShadowsResources& operator=(const ShadowsResources&) = delete;
+	~ShadowsResources() = default;
+
+	void Initialize();
+	void Update();
+	void PreparePrevFrameShadowMap();
+
+	void GUINewFrame();
+
+	ID3D12Resource* GetShadowMapHWR() { return _shadowMapHWR.Get(); }
+	ID3D12Resource* GetShadowMapSWR() { return _shadowMapSWR.Get(); }
+	ID3D12Resource* GetPrevFrameShadowMap()
+	{
+		return _prevFrameShadowMap.Get();
+	}
+	ID3D12PipelineState* GetPSO() { return _shadowsPSO.Get(); }
+	const CD3DX12_VIEWPORT& GetViewport() { return _viewport; }
+	const CD3DX12_RECT& GetScissorRect() { return _scissorRect; }
+
+	UINT GetCascadesCount() const { return _cascadesCount; }
+	const DirectX::XMFLOAT4X4& GetCascadeVP(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeVP[cascade];
+	}
+	const DirectX::XMFLOAT4X4& GetPrevFrameCascadeVP(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _prevFrameCascadeVP[cascade];
+	}
+	float GetCascadeBias(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeBias[cascade];
+	}
+	float GetCascadeSplitNormalized(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeSplitsNormalized[cascade];
+	}
+	float GetCascadeSplit(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeSplits[cascade];
+	}
+	const Frustum& GetCascadeFrustum(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeFrustums[cascade];
+	}
+	const DirectX::XMFLOAT4& GetCascadeCameraPosition(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeCameraPosition[cascade];
+	}
+
+	bool ShowCascades() const { return _showCascades; }
+
+	void InvalidateCascadesCache();
+	// if the cascade map has to be drawn, its cached one is kept otherwise
+	bool IsCascadeDirty(UINT cascade) const
+	{
+		assert(cascade < Settings::MaxCascadesCount);
+		return _cascadeDirty[cascade];
+	}
+	// by the rasterizer drawing to the cached maps
+	void OnCascadesDrawn();
+	// CPU only, prints the redraws of each cascade
+	void ReplayCameraPaths();
+
+private:
+
+	static const float ShadowMinDistance;
+	static const UINT ReplayFramesCount;
+
+	void _createHWRShadowMapResources();
+	void _createSWRShadowMapResources();
+	void _createPrevFrameShadowMapResources();
+	void _createPSO();
+	void _updateFrustumPlanes();
+	bool _placeStabilizedCascade(
+		UINT cascade,
+		const DirectX::XMVECTOR* splitCornersWS,
+		DirectX::FXMVECTOR splitCenter);
+	void _computeNearAndFar(
+		FLOAT& fNearPlane,
+		FLOAT& fFarPlane,
+		DirectX::FXMVECTOR vLightCameraOrthographicMin,
+		DirectX::FXMVECTOR vLightCameraOrthographicMax,
+		DirectX::XMVECTOR* pvPointsInCameraView);
+
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _shadowsRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _shadowsPSO;
+	// for hardware rasterizer pipeline
+	Microsoft::WRL::ComPtr<ID3D12Resource> _shadowMapHWR;
+	// SWR needs unordered writes
+	Microsoft::WRL::ComPtr<ID3D12Resource> _shadowMapSWR;
+	// for Hi-Z culling
+	Microsoft::WRL::ComPtr<ID3D12Resource> _prevFrameShadowMap;
+	CD3DX12_VIEWPORT _viewport;
+	CD3DX12_RECT _scissorRect;
+
+	DirectX::XMFLOAT4 _cascadeCameraPosition[Settings::MaxCascadesCount];
+	DirectX::XMFLOAT4X4 _cascadeVP[Settings::MaxCascadesCount];
+	DirectX::XMFLOAT4X4 _prevFrameCascadeVP[Settings::MaxCascadesCount];
+	Frustum _cascadeFrustums[Settings::MaxCascadesCount];
+	float _cascadeBias[Settings::MaxCascadesCount];
+	float _cascadeSplitsNormalized[Settings::MaxCascadesCount];
+	float _cascadeSplits[Settings::MaxCascadesCount];
+	UINT _cascadesCount;
+	float _shadowDistance = 5000.0f;
+	bool _boundCascadesBySpheres = false;
+	float _bias = 0.001f;
+
+	bool _stabilizeCascades = false;
+	// only the stabilized ones are cached
+	bool _cacheCascades = false;
+	float _cacheGuardTexels = 64.0f;
+	bool _cascadeDirty[Settings::MaxCascadesCount] = {};
+	bool _cascadeCached[Settings::MaxCascadesCount] = {};
+	// light space center and half size
+	DirectX::XMFLOAT3 _cascadeCachedPlacement[Settings::MaxCascadesCount];
+	const Scene* _cachedScene = nullptr;
+	DirectX::XMFLOAT3 _cachedLightDirection = {};
+	bool _cachedSWREnabled = false;
+
+	// debug and visualisation stuff
+	bool _showCascades = false;
 };
\ No newline at end of file
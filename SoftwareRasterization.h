@@ -1,123 +1,166 @@
-#pragma once
-
-#include "DX.h"
-#include "Utils.h"
-#include "Shadows.h"
-
-class ForwardRenderer;
-
-class SoftwareRasterization
-{
-public:
-
-	SoftwareRasterization() = default;
-	SoftwareRasterization(const SoftwareRasterization&) = delete;
-	SoftwareRasterization& operator=(const SoftwareRasterization&) = delete;
-	~SoftwareRasterization() = default;
-
-	void Resize(
-		ForwardRenderer* renderer,
-		UINT width,
-		UINT height);
-	void GUINewFrame();
-	void Update();
-	void Draw();
-
-	ID3D12Resource* GetRenderTarget() const { return _renderTarget.Get(); }
-
-	UINT GetPipelineTrianglesCount() const
-	{
-		return _statsResult[PipelineTriangles];
-	}
-
-	UINT GetRenderedTrianglesCount() const
-	{
-		return _statsResult[RenderedTriangles];
-	}
-
-private:
-
-	void _createRenderTargetResources();
-	void _createDepthBufferResources();
-	void _createMDIResources();
-	void _createResetBuffer();
-	void _clearBigTrianglesCounter(UINT frustum);
-	void _createStatsResources();
-	void _clearStatistics();
-
-	void _beginFrame();
-	void _drawDepth();
-	void _drawDepthBigTriangles();
-	void _drawShadows();
-	void _drawShadowsBigTriangles();
-	void _finishDepthsRendering();
-	void _drawOpaque();
-	void _endFrame();
-
-	void _drawIndexedInstanced(
-		UINT indexCountPerInstance,
-		UINT instanceCount,
-		UINT startIndexLocation,
-		INT baseVertexLocation,
-		UINT startInstanceLocation);
-
-	void _createTriangleDepthPSO();
-	void _createBigTriangleDepthPSO();
-	void _createTriangleOpaquePSO();
-	void _createBigTriangleOpaquePSO();
-	void _createBigTrianglesBuffers();
-
-	// need these two for UAV writes
-	Microsoft::WRL::ComPtr<ID3D12Resource> _renderTarget;
-	Microsoft::WRL::ComPtr<ID3D12Resource> _depthBuffer;
-
-	Microsoft::WRL::ComPtr<ID3D12RootSignature> _triangleDepthRS;
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> _triangleDepthPSO;
-	Microsoft::WRL::ComPtr<ID3D12RootSignature> _bigTriangleDepthRS;
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> _bigTriangleDepthPSO;
-	Microsoft::WRL::ComPtr<ID3D12RootSignature> _triangleOpaqueRS;
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> _triangleOpaquePSO;
-	Microsoft::WRL::ComPtr<ID3D12RootSignature> _bigTriangleOpaqueRS;
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> _bigTriangleOpaquePSO;
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_bigTriangles[Settings::FrustumsCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource> _depthSceneCB;
-	UINT8* _depthSceneCBData;
-	UINT _depthSceneCBFrameSize = 0;
-	Microsoft::WRL::ComPtr<ID3D12Resource> _sceneCB;
-	UINT8* _sceneCBData;
-
-	UINT _width = 0;
-	UINT _height = 0;
-	ForwardRenderer* _renderer;
-
-	// MDI stuff
-	Microsoft::WRL::ComPtr<ID3D12CommandSignature> _dispatchCS;
-	// first 4 bytes used as a counter
-	// all 12 bytes are used as a dispatch indirect command
-	// [0] - counter / group count X
-	// [1] - group count Y
-	// [2] - group count Z
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_bigTrianglesCounters[Settings::FrustumsCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_bigTrianglesCountersUpload[Settings::FrustumsCount];
-	Microsoft::WRL::ComPtr<ID3D12Resource> _counterReset;
-
-	// statistics resources
-	enum StatsIndices
-	{
-		PipelineTriangles,
-		RenderedTriangles,
-		StatsCount
-	};
-	Microsoft::WRL::ComPtr<ID3D12Resource> _trianglesStats;
-	Microsoft::WRL::ComPtr<ID3D12Resource>
-		_trianglesStatsReadback[DX::FramesCount];
-	UINT _statsResult[StatsCount];
-
-	// how much screen space area should triangle's AABB occupy
-	// to be considered "big"
-	INT _bigTriangleThreshold = 64;
-	INT _bigTriangleTileSize = 128;
+#pragma once
+
+#include "DX.h"
+#include "Utils.h"
+#include "Shadows.h"
+
+#include <vector>
+
+class ForwardRenderer;
+
+class SoftwareRasterization
+{
+public:
+
+	SoftwareRasterization() = default;
+	SoftwareRasterization(const SoftwareRasterization&) = delete;
+	SoftwareRasterization& operator=(const SoftwareRasterization&) = delete;
+	~SoftwareRasterization() = default;
+
+	void Resize(
+		ForwardRenderer* renderer,
+		UINT width,
+		UINT height);
+	void GUINewFrame();
+	void Update();
+	void Draw();
+
+	ID3D12Resource* GetRenderTarget() const { return _renderTarget.Get(); }
+	// records a copy of the render target into a readback buffer,
+	// which is valid to be read once GPU is done with the frame
+	void ReadbackRenderTarget();
+	void GetRenderTargetReadback(std::vector<DirectX::XMFLOAT4>& result);
+
+	UINT GetPipelineTrianglesCount() const
+	{
+		return _statsResult[PipelineTriangles];
+	}
+
+	UINT GetRenderedTrianglesCount() const
+	{
+		return _statsResult[RenderedTriangles];
+	}
+
+	// rasterized per pixel by the triangle passes,
+	// since the big triangles queue of their view was full
+	UINT GetSpilledBigTrianglesCount() const
+	{
+		return _statsResult[SpilledBigTriangles];
+	}
+
+	// a queue got more records than it holds in a previous frame
+	bool IsBigTrianglesResizeRequested() const;
+	// GPU must be idle, since the queues are shared by the frames in flight
+	void ResizeBigTrianglesBuffers();
+
+private:
+
+	void _createRenderTargetResources();
+	void _createDepthBufferResources();
+	void _createMDIResources();
+	void _createResetBuffer();
+	void _clearBigTrianglesCounter(UINT frustum);
+	// prefix sum of the tiles of the queued triangles
+	void _scanBigTriangles(UINT frustum);
+	void _createStatsResources();
+	void _clearStatistics();
+
+	void _beginFrame();
+	void _drawDepth();
+	void _drawDepthBigTriangles();
+	void _drawShadows();
+	void _drawShadowsBigTriangles();
+	void _finishDepthsRendering();
+	void _drawOpaque();
+	void _endFrame();
+
+	void _drawIndexedInstanced(
+		UINT indexCountPerInstance,
+		UINT instanceCount,
+		UINT startIndexLocation,
+		INT baseVertexLocation,
+		UINT startInstanceLocation);
+
+	void _createTriangleDepthPSO();
+	void _createBigTriangleDepthPSO();
+	void _createTriangleOpaquePSO();
+	void _createBigTriangleOpaquePSO();
+	void _createBigTriangleScanPSO();
+	void _createBigTrianglesBuffers();
+	void _createBigTrianglesBuffer(UINT frustum);
+	// from the records asked for in the last read back frame
+	void _checkBigTrianglesCapacity();
+
+	// need these two for UAV writes
+	Microsoft::WRL::ComPtr<ID3D12Resource> _renderTarget;
+	Microsoft::WRL::ComPtr<ID3D12Resource> _depthBuffer;
+	// for comparison with the CPU rasterizer
+	Microsoft::WRL::ComPtr<ID3D12Resource> _renderTargetReadback;
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT _renderTargetFootprint;
+
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _triangleDepthRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _triangleDepthPSO;
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _bigTriangleDepthRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _bigTriangleDepthPSO;
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _triangleOpaqueRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _triangleOpaquePSO;
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _bigTriangleOpaqueRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _bigTriangleOpaquePSO;
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> _bigTriangleScanRS;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> _bigTriangleScanPSO;
+	// 384 KB, enough for most of the views
+	static constexpr UINT InitialBigTrianglesCapacity = 4096;
+	// every triangle has a tile, and every tile is a thread group
+	// of the big triangle pass
+	static constexpr UINT MaxBigTrianglesCapacity =
+		D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_bigTriangles[Settings::FrustumsCount];
+	// in triangles
+	UINT _bigTrianglesCapacity[Settings::FrustumsCount] = {};
+	UINT _bigTrianglesRequiredCapacity[Settings::FrustumsCount] = {};
+	bool _bigTrianglesOverflowReported[Settings::FrustumsCount] = {};
+	Microsoft::WRL::ComPtr<ID3D12Resource> _depthSceneCB;
+	UINT8* _depthSceneCBData;
+	UINT _depthSceneCBFrameSize = 0;
+	Microsoft::WRL::ComPtr<ID3D12Resource> _sceneCB;
+	UINT8* _sceneCBData;
+
+	UINT _width = 0;
+	UINT _height = 0;
+	ForwardRenderer* _renderer;
+
+	// MDI stuff
+	Microsoft::WRL::ComPtr<ID3D12CommandSignature> _dispatchCS;
+	// first 12 bytes are used as a dispatch indirect command
+	// [0] - tiles of the queued triangles / group count X
+	// [1] - group count Y
+	// [2] - group count Z
+	// [3] - queued triangles, never past the queue's capacity
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_bigTrianglesCounters[Settings::FrustumsCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_bigTrianglesCountersUpload[Settings::FrustumsCount];
+	Microsoft::WRL::ComPtr<ID3D12Resource> _counterReset;
+
+	// statistics resources
+	// should match the ones in TypesAndConstants.hlsli
+	enum StatsIndices
+	{
+		PipelineTriangles,
+		RenderedTriangles,
+		// + frustum, triangles asked to be queued
+		BigTriangleRecords,
+		SpilledBigTriangles = BigTriangleRecords + Settings::MaxViewsCount,
+		StatsCount
+	};
+	Microsoft::WRL::ComPtr<ID3D12Resource> _trianglesStats;
+	Microsoft::WRL::ComPtr<ID3D12Resource>
+		_trianglesStatsReadback[DX::FramesCount];
+	UINT _statsResult[StatsCount];
+
+	// how much screen space area should triangle's AABB occupy
+	// to be considered "big"
+	INT _bigTriangleThreshold = 64;
+	INT _bigTriangleTileSize = 128;
 };
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(UINT workersCount)
+{
+	if (workersCount == 0)
+	{
+		workersCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	_workers.resize(workersCount);
+	for (auto& worker : _workers)
+	{
+		worker = std::make_unique<Worker>();
+	}
+	for (UINT worker = 0; worker < workersCount; worker++)
+	{
+		_workers[worker]->thread =
+			std::thread(&ThreadPool::_workerLoop, this, worker);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_workAvailable.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		worker->thread.join();
+	}
+}
+
+void ThreadPool::ParallelFor(UINT tasksCount, const Task& task)
+{
+	if (tasksCount == 0)
+	{
+		return;
+	}
+
+	_task = &task;
+	_remainingTasks = tasksCount;
+
+	// contiguous ranges keep neighbouring tasks on the same worker,
+	// stealing takes care of the imbalance
+	UINT workersCount = GetWorkersCount();
+	for (UINT worker = 0; worker < workersCount; worker++)
+	{
+		UINT begin = static_cast<UINT>(
+			static_cast<UINT64>(tasksCount) * worker / workersCount);
+		UINT end = static_cast<UINT>(
+			static_cast<UINT64>(tasksCount) * (worker + 1) / workersCount);
+
+		std::lock_guard<std::mutex> lock(_workers[worker]->mutex);
+		for (UINT t = begin; t < end; t++)
+		{
+			_workers[worker]->tasks.push_back(t);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_generation++;
+	}
+	_workAvailable.notify_all();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_workDone.wait(lock, [this] { return _remainingTasks == 0; });
+	_task = nullptr;
+}
+
+void ThreadPool::_workerLoop(UINT worker)
+{
+	UINT64 generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_workAvailable.wait(
+				lock,
+				[this, generation] {
+					return _stop || _generation != generation;
+				});
+			if (_stop)
+			{
+				return;
+			}
+			generation = _generation;
+		}
+
+		UINT task = 0;
+		while (_popTask(worker, task) || _stealTask(worker, task))
+		{
+			(*_task)(task, worker);
+
+			if (_remainingTasks.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_workDone.notify_one();
+			}
+		}
+	}
+}
+
+bool ThreadPool::_popTask(UINT worker, UINT& task)
+{
+	Worker& owner = *_workers[worker];
+	std::lock_guard<std::mutex> lock(owner.mutex);
+	if (owner.tasks.empty())
+	{
+		return false;
+	}
+
+	task = owner.tasks.back();
+	owner.tasks.pop_back();
+	return true;
+}
+
+bool ThreadPool::_stealTask(UINT worker, UINT& task)
+{
+	UINT workersCount = GetWorkersCount();
+	for (UINT offset = 1; offset < workersCount; offset++)
+	{
+		Worker& victim = *_workers[(worker + offset) % workersCount];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
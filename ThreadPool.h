@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// work-stealing thread pool, every worker owns a queue of tasks,
+// pops from its back and steals from the front of others' queues
+// once its own is empty
+class ThreadPool
+{
+public:
+
+	// task index, index of the worker executing it
+	using Task = std::function<void(UINT, UINT)>;
+
+	// 0 - one worker per hardware thread
+	explicit ThreadPool(UINT workersCount = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	// blocks until all tasks are done, nested calls are not supported
+	void ParallelFor(UINT tasksCount, const Task& task);
+
+	UINT GetWorkersCount() const
+	{
+		return static_cast<UINT>(_workers.size());
+	}
+
+private:
+
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<UINT> tasks;
+		std::thread thread;
+	};
+
+	void _workerLoop(UINT worker);
+	bool _popTask(UINT worker, UINT& task);
+	bool _stealTask(UINT worker, UINT& task);
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+	// valid while ParallelFor is running
+	const Task* _task = nullptr;
+	std::atomic<UINT> _remainingTasks = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _workAvailable;
+	std::condition_variable _workDone;
+	UINT64 _generation = 0;
+	bool _stop = false;
+};
\ No newline at end of file
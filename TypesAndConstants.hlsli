@@ -1,119 +1,177 @@
-#ifndef TYPES_AND_CONSTANTS_HLSL
-#define TYPES_AND_CONSTANTS_HLSL
-
-static const uint MaxCascadesCount = 8;
-static const float3 SkyColor = float3(136.0, 198.0, 252.0) / 255.0;
-
-static const float FloatMax = 3.402823466e+38;
-static const float FloatMin = 1.175494351e-38;
-
-static const uint SWRBigTriangleThreadsX = 8;
-static const uint SWRBigTriangleThreadsY = 8;
-static const uint SWRBigTriangleThreadsZ = 1;
-
-// should match it's duplicates in Setttings.h
-static const uint CullingThreadsX = 256;
-static const uint CullingThreadsY = 1;
-static const uint CullingThreadsZ = 1;
-
-static const uint SWRTriangleThreadsX = 256;
-static const uint SWRTriangleThreadsY = 1;
-static const uint SWRTriangleThreadsZ = 1;
-
-static const uint HiZThreadsX = 16;
-static const uint HiZThreadsY = 16;
-static const uint HiZThreadsZ = 1;
-
-// https://developer.nvidia.com/content/understanding-structured-buffer-performance
-
-struct VertexPosition
-{
-	float3 position;
-};
-
-struct VertexNormal
-{
-	// | 2 bits - unused | 10 bits - x | 10 bits - y | 10 bits - z |
-	uint packedNormal;
-};
-
-struct VertexColor
-{
-	// .x : |16 bits - r component | 16 bits - g component |
-	// .y : |16 bits - b component | 16 bits - a component |
-	uint2 packedColor;
-};
-
-struct VertexUV
-{
-	// | 16 bits - u | 16 bits - v |
-	uint packedUV;
-};
-
-struct Frustum
-{
-	float4 left;
-	float4 right;
-	float4 bottom;
-	float4 top;
-	float4 near;
-	float4 far;
-
-	float4 corners[8];
-};
-
-struct AABB
-{
-	float3 center;
-	float pad0;
-	float3 extents;
-	float pad1;
-};
-
-struct MeshMeta
-{
-	AABB aabb;
-
-	uint indexCountPerInstance;
-	uint instanceCount;
-	uint startIndexLocation;
-	int baseVertexLocation;
-	uint startInstanceLocation;
-
-	float3 coneApex;
-	float3 coneAxis;
-	float coneCutoff;
-};
-
-struct Instance
-{
-	float4x4 worldTransform;
-	uint meshID;
-	float3 color;
-};
-
-struct DrawIndexedArguments
-{
-	uint indexCountPerInstance;
-	uint instanceCount;
-	uint startIndexLocation;
-	int baseVertexLocation;
-	uint startInstanceLocation;
-};
-
-struct IndirectCommand
-{
-	uint startInstanceLocation;
-	DrawIndexedArguments args;
-};
-
-struct BigTriangle
-{
-	uint triangleIndex;
-	uint instanceIndex;
-	int baseVertexLocation;
-
-	float tileOffset;
-};
-
+#ifndef TYPES_AND_CONSTANTS_HLSL
+#define TYPES_AND_CONSTANTS_HLSL
+
+static const uint MaxCascadesCount = 8;
+// camera + cascades + extra views, e.g. split-screen or probes
+static const uint MaxViewsCount = 1 + MaxCascadesCount;
+static const float3 SkyColor = float3(136.0, 198.0, 252.0) / 255.0;
+
+static const float FloatMax = 3.402823466e+38;
+static const float FloatMin = 1.175494351e-38;
+
+static const uint SWRBigTriangleThreadsX = 8;
+static const uint SWRBigTriangleThreadsY = 8;
+static const uint SWRBigTriangleThreadsZ = 1;
+
+// should match it's duplicates in Setttings.h
+static const uint CullingThreadsX = 256;
+static const uint CullingThreadsY = 1;
+static const uint CullingThreadsZ = 1;
+
+static const uint SWRTriangleThreadsX = 256;
+static const uint SWRTriangleThreadsY = 1;
+static const uint SWRTriangleThreadsZ = 1;
+
+// indices into the SWR statistics buffer,
+// should match SoftwareRasterization::StatsIndices
+static const uint PipelineTrianglesStat = 0;
+static const uint RenderedTrianglesStat = 1;
+// + view index, big triangles asked to be queued, fitting or not
+static const uint BigTriangleRecordsStat = 2;
+// rasterized by the triangle pass, since the queue was full
+static const uint SpilledBigTrianglesStat =
+	BigTriangleRecordsStat + MaxViewsCount;
+
+// byte offsets into the big triangles counter,
+// which is also the dispatch arguments of the big triangle passes
+static const uint BigTriangleTilesOffset = 0;
+static const uint BigTrianglesCountOffset = 12;
+// one thread group per tile,
+// should match D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION
+static const uint MaxBigTriangleTiles = 65535;
+
+static const uint SWRBigTriangleScanThreads = 256;
+
+static const uint HiZThreadsX = 16;
+static const uint HiZThreadsY = 16;
+static const uint HiZThreadsZ = 1;
+
+// https://developer.nvidia.com/content/understanding-structured-buffer-performance
+
+struct VertexPosition
+{
+	float3 position;
+};
+
+struct VertexNormal
+{
+	// | 2 bits - unused | 10 bits - x | 10 bits - y | 10 bits - z |
+	uint packedNormal;
+};
+
+struct VertexColor
+{
+	// .x : |16 bits - r component | 16 bits - g component |
+	// .y : |16 bits - b component | 16 bits - a component |
+	uint2 packedColor;
+};
+
+struct VertexUV
+{
+	// | 16 bits - u | 16 bits - v |
+	uint packedUV;
+};
+
+struct Frustum
+{
+	float4 left;
+	float4 right;
+	float4 bottom;
+	float4 top;
+	float4 near;
+	float4 far;
+
+	float4 corners[8];
+};
+
+// everything culler needs to know about a single view
+struct CullingView
+{
+	Frustum frustum;
+	float4x4 VP;
+	float4x4 prevFrameVP;
+	float3 position;
+	uint HiZCullingEnabled;
+	float2 HiZResolution;
+	float2 pad;
+};
+
+struct AABB
+{
+	float3 center;
+	float pad0;
+	float3 extents;
+	float pad1;
+};
+
+struct MeshMeta
+{
+	AABB aabb;
+	// .xyz - center, .w - radius
+	float4 boundingSphere;
+
+	uint indexCountPerInstance;
+	uint instanceCount;
+	uint startIndexLocation;
+	int baseVertexLocation;
+	uint startInstanceLocation;
+
+	float3 coneApex;
+	float3 coneAxis;
+	float coneCutoff;
+};
+
+struct Instance
+{
+	float4x4 worldTransform;
+	uint meshID;
+	float3 color;
+};
+
+struct DrawIndexedArguments
+{
+	uint indexCountPerInstance;
+	uint instanceCount;
+	uint startIndexLocation;
+	int baseVertexLocation;
+	uint startInstanceLocation;
+};
+
+struct IndirectCommand
+{
+	uint startInstanceLocation;
+	DrawIndexedArguments args;
+};
+
+// one per triangle, expanded into tiles by the big triangle passes
+struct BigTriangle
+{
+	// setup of the triangle passes, shared by all the tiles
+	float2 p0SS;
+	float2 p1SS;
+	float2 p2SS;
+	// snapped to pixel centers and clamped to screen bounds
+	float2 minP;
+	float2 maxP;
+	float z0NDC;
+	float z1NDC;
+	float z2NDC;
+	float invW0;
+	float invW1;
+	float invW2;
+	float invArea;
+
+	// of BigTriangleTileSize, row by row from minP
+	uint tilesX;
+	uint tilesCount;
+	// exclusive prefix sum of tilesCount, see BigTriangleScanCS
+	uint firstTile;
+
+	// for the attributes of the opaque pass
+	uint triangleIndex;
+	uint instanceIndex;
+	int baseVertexLocation;
+	uint pad;
+};
+
 #endif // TYPES_AND_CONSTANTS_HLSL
\ No newline at end of file
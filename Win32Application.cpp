@@ -1,160 +1,160 @@
-//*********************************************************
-//
-// Copyright (c) Microsoft. All rights reserved.
-// This code is licensed under the MIT License (MIT).
-// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
-// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
-// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
-// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
-//
-//*********************************************************
-
-#include "Common.h"
-#include "Win32Application.h"
-#include "DXSample.h"
-#include "imgui/imgui_impl_win32.h"
-
-HWND Win32Application::m_hwnd = nullptr;
-
-int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
-{
-	// Parse the command line parameters
-	int argc;
-	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
-	pSample->ParseCommandLineArgs(argv, argc);
-	LocalFree(argv);
-
-	// Initialize the window class.
-	WNDCLASSEX windowClass = { 0 };
-	windowClass.cbSize = sizeof(WNDCLASSEX);
-	windowClass.style = CS_HREDRAW | CS_VREDRAW;
-	windowClass.lpfnWndProc = WindowProc;
-	windowClass.hInstance = hInstance;
-	windowClass.hCursor = LoadCursor(NULL, IDC_ARROW);
-	windowClass.lpszClassName = L"DXSampleClass";
-	RegisterClassEx(&windowClass);
-
-	RECT windowRect =
-	{
-		0,
-		0,
-		static_cast<LONG>(pSample->GetWidth()),
-		static_cast<LONG>(pSample->GetHeight())
-	};
-	AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
-
-	// Create the window and store a handle to it.
-	m_hwnd = CreateWindow(
-		windowClass.lpszClassName,
-		pSample->GetTitle(),
-		WS_OVERLAPPEDWINDOW,
-		CW_USEDEFAULT,
-		CW_USEDEFAULT,
-		windowRect.right - windowRect.left,
-		windowRect.bottom - windowRect.top,
-		nullptr, // We have no parent window.
-		nullptr, // We aren't using menus.
-		hInstance,
-		pSample);
-
-	// Initialize the sample. OnInit is defined in each child-implementation of DXSample.
-	pSample->OnInit();
-
-	ShowWindow(m_hwnd, nCmdShow);
-
-	// Main sample loop.
-	MSG msg = {};
-	while (msg.message != WM_QUIT)
-	{
-		// Process any messages in the queue.
-		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
-		{
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
-		}
-	}
-
-	pSample->OnDestroy();
-
-	// Return this part of the WM_QUIT message to Windows.
-	return static_cast<char>(msg.wParam);
-}
-
-extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(
-	HWND hWnd,
-	UINT msg,
-	WPARAM wParam,
-	LPARAM lParam);
-
-// Main message handler for the sample.
-LRESULT CALLBACK Win32Application::WindowProc(
-	HWND hWnd,
-	UINT message,
-	WPARAM wParam,
-	LPARAM lParam)
-{
-	DXSample* pSample = reinterpret_cast<DXSample*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-
-	if (ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam))
-	{
-		return true;
-	}
-
-	switch (message)
-	{
-	case WM_CREATE:
-	{
-		// Save the DXSample* passed in to CreateWindow.
-		LPCREATESTRUCT pCreateStruct = reinterpret_cast<LPCREATESTRUCT>(lParam);
-		SetWindowLongPtr(
-			hWnd,
-			GWLP_USERDATA,
-			reinterpret_cast<LONG_PTR>(pCreateStruct->lpCreateParams));
-
-		return 0;
-	}
-
-	case WM_MOUSEMOVE:
-	{
-		UINT x = LOWORD(lParam);
-		UINT y = HIWORD(lParam);
-		if (pSample && static_cast<UINT8>(wParam) == MK_RBUTTON)
-		{
-			pSample->OnMouseMove(x, y);
-		}
-		else if (pSample)
-		{
-			pSample->OnRightButtonDown(x, y);
-		}
-		return 0;
-	}
-
-	case WM_KEYDOWN:
-	{
-		if (pSample)
-		{
-			pSample->OnKeyDown(static_cast<UINT8>(wParam));
-		}
-		return 0;
-	}
-
-	case WM_PAINT:
-	{
-		if (pSample)
-		{
-			pSample->OnUpdate();
-			pSample->OnRender();
-		}
-		return 0;
-	}
-
-	case WM_DESTROY:
-	{
-		PostQuitMessage(0);
-		return 0;
-	}
-	}
-
-	// Handle any messages the switch statement didn't.
-	return DefWindowProc(hWnd, message, wParam, lParam);
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "Common.h"
+#include "Win32Application.h"
+#include "DXSample.h"
+#include "imgui/imgui_impl_win32.h"
+
+HWND Win32Application::m_hwnd = nullptr;
+
+int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
+{
+	// Parse the command line parameters
+	int argc;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	pSample->ParseCommandLineArgs(argv, argc);
+	LocalFree(argv);
+
+	// Initialize the window class.
+	WNDCLASSEX windowClass = { 0 };
+	windowClass.cbSize = sizeof(WNDCLASSEX);
+	windowClass.style = CS_HREDRAW | CS_VREDRAW;
+	windowClass.lpfnWndProc = WindowProc;
+	windowClass.hInstance = hInstance;
+	windowClass.hCursor = LoadCursor(NULL, IDC_ARROW);
+	windowClass.lpszClassName = L"DXSampleClass";
+	RegisterClassEx(&windowClass);
+
+	RECT windowRect =
+	{
+		0,
+		0,
+		static_cast<LONG>(pSample->GetWidth()),
+		static_cast<LONG>(pSample->GetHeight())
+	};
+	AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
+
+	// Create the window and store a handle to it.
+	m_hwnd = CreateWindow(
+		windowClass.lpszClassName,
+		pSample->GetTitle(),
+		WS_OVERLAPPEDWINDOW,
+		CW_USEDEFAULT,
+		CW_USEDEFAULT,
+		windowRect.right - windowRect.left,
+		windowRect.bottom - windowRect.top,
+		nullptr, // We have no parent window.
+		nullptr, // We aren't using menus.
+		hInstance,
+		pSample);
+
+	// Initialize the sample. OnInit is defined in each child-implementation of DXSample.
+	pSample->OnInit();
+
+	ShowWindow(m_hwnd, nCmdShow);
+
+	// Main sample loop.
+	MSG msg = {};
+	while (msg.message != WM_QUIT)
+	{
+		// Process any messages in the queue.
+		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		{
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+
+	pSample->OnDestroy();
+
+	// Return this part of the WM_QUIT message to Windows.
+	return static_cast<char>(msg.wParam);
+}
+
+extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(
+	HWND hWnd,
+	UINT msg,
+	WPARAM wParam,
+	LPARAM lParam);
+
+// Main message handler for the sample.
+LRESULT CALLBACK Win32Application::WindowProc(
+	HWND hWnd,
+	UINT message,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	DXSample* pSample = reinterpret_cast<DXSample*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+
+	if (ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam))
+	{
+		return true;
+	}
+
+	switch (message)
+	{
+	case WM_CREATE:
+	{
+		// Save the DXSample* passed in to CreateWindow.
+		LPCREATESTRUCT pCreateStruct = reinterpret_cast<LPCREATESTRUCT>(lParam);
+		SetWindowLongPtr(
+			hWnd,
+			GWLP_USERDATA,
+			reinterpret_cast<LONG_PTR>(pCreateStruct->lpCreateParams));
+
+		return 0;
+	}
+
+	case WM_MOUSEMOVE:
+	{
+		UINT x = LOWORD(lParam);
+		UINT y = HIWORD(lParam);
+		if (pSample && static_cast<UINT8>(wParam) == MK_RBUTTON)
+		{
+			pSample->OnMouseMove(x, y);
+		}
+		else if (pSample)
+		{
+			pSample->OnRightButtonDown(x, y);
+		}
+		return 0;
+	}
+
+	case WM_KEYDOWN:
+	{
+		if (pSample)
+		{
+			pSample->OnKeyDown(static_cast<UINT8>(wParam));
+		}
+		return 0;
+	}
+
+	case WM_PAINT:
+	{
+		if (pSample)
+		{
+			pSample->OnUpdate();
+			pSample->OnRender();
+		}
+		return 0;
+	}
+
+	case WM_DESTROY:
+	{
+		PostQuitMessage(0);
+		return 0;
+	}
+	}
+
+	// Handle any messages the switch statement didn't.
+	return DefWindowProc(hWnd, message, wParam, lParam);
 }
\ No newline at end of file